@@ -0,0 +1,49 @@
+#include <iomanip>
+
+#include "Benchmark.h"
+
+namespace Benchmark
+{
+
+void
+Reporter::write() const
+{
+  mOut << std::fixed << std::setprecision(1);
+  if (mFormat == Format::Csv)
+  {
+    mOut << "container,operation,writers,readers,payload_bytes,capacity,ops_per_second,p50_ns,p99_ns,p999_ns\n";
+    for (const auto& result : mResults)
+    {
+      mOut << result.container << ',' << result.operation << ',' << result.writers << ',' << result.readers << ',' << result.payloadBytes << ','
+           << result.capacity << ',' << result.opsPerSecond << ',' << result.p50Ns << ',' << result.p99Ns << ',' << result.p999Ns << '\n';
+    }
+  }
+  else
+  {
+    mOut << "[\n";
+    for (std::size_t i = 0; i < mResults.size(); ++i)
+    {
+      const auto& result = mResults[i];
+      mOut << "  { \"container\": \"" << result.container << "\", \"operation\": \"" << result.operation << "\", \"writers\": " << result.writers
+           << ", \"readers\": " << result.readers << ", \"payload_bytes\": " << result.payloadBytes << ", \"capacity\": " << result.capacity
+           << ", \"ops_per_second\": " << result.opsPerSecond << ", \"p50_ns\": " << result.p50Ns << ", \"p99_ns\": " << result.p99Ns
+           << ", \"p999_ns\": " << result.p999Ns << " }" << (i + 1 < mResults.size() ? "," : "") << '\n';
+    }
+    mOut << "]\n";
+  }
+  mOut.flush();
+}
+
+std::vector<std::size_t>
+threadCounts(std::size_t maxThreads)
+{
+  std::vector<std::size_t> counts;
+  for (std::size_t count = 1; count < maxThreads; count *= 2)
+  {
+    counts.push_back(count);
+  }
+  counts.push_back(std::max<std::size_t>(maxThreads, 1));
+  return counts;
+}
+
+} // End namespace Benchmark
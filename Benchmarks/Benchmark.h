@@ -0,0 +1,112 @@
+#ifndef CONCURRENT_BENCHMARK_H
+#define CONCURRENT_BENCHMARK_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Benchmark
+{
+
+using clock = std::chrono::steady_clock;
+
+struct Config
+{
+  std::size_t               maxThreads; // Largest number of producers/consumers/readers to run
+  std::size_t               items;      // Number of items passed through a queue in each run
+  std::chrono::milliseconds duration;   // Length of each SearchRingBuffer run
+};
+
+// One row of output
+struct Result
+{
+  std::string container;
+  std::string operation;
+  std::size_t writers;      // Producers
+  std::size_t readers;      // Consumers or SearchRingBuffer readers
+  std::size_t payloadBytes; // sizeof(T)
+  std::size_t capacity;     // Fixed capacity of the container, 0 if unbounded
+  double      opsPerSecond;
+  double      p50Ns; // Latency percentiles, 0 if latency was not measured
+  double      p99Ns;
+  double      p999Ns;
+};
+
+// Collects latency samples in nanoseconds. Each thread should use its own recorder and merge them afterwards.
+class LatencyRecorder
+{
+public:
+  void reserve(std::size_t count) { mSamples.reserve(count); }
+  void record(clock::duration latency) { mSamples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()); }
+  void merge(const LatencyRecorder& other) { mSamples.insert(mSamples.end(), other.mSamples.begin(), other.mSamples.end()); }
+
+  // Sorts the samples. p is in the range [0, 1]
+  double
+  percentile(double p)
+  {
+    if (mSamples.empty())
+    {
+      return 0;
+    }
+    std::sort(mSamples.begin(), mSamples.end());
+    const auto index = static_cast<std::size_t>(p * static_cast<double>(mSamples.size() - 1));
+    return static_cast<double>(mSamples[index]);
+  }
+
+private:
+  std::vector<std::int64_t> mSamples;
+};
+
+// Released by the main thread once every worker thread has been created so they all start together
+class StartGate
+{
+public:
+  void open() { mOpen.store(true, std::memory_order_release); }
+  void
+  wait() const
+  {
+    while (!mOpen.load(std::memory_order_acquire))
+    {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  std::atomic<bool> mOpen{ false };
+};
+
+// Writes results as CSV or JSON
+class Reporter
+{
+public:
+  enum class Format
+  {
+    Csv,
+    Json
+  };
+
+  Reporter(std::ostream& out, Format format) : mOut(out), mFormat(format) {}
+
+  void add(const Result& result) { mResults.push_back(result); }
+  void write() const;
+
+private:
+  std::ostream&       mOut;
+  Format              mFormat;
+  std::vector<Result> mResults;
+};
+
+// 1, 2, 4, ... up to and including maxThreads
+std::vector<std::size_t> threadCounts(std::size_t maxThreads);
+
+void runQueueBenchmarks(const Config& config, Reporter& reporter);
+void runSearchRingBufferBenchmarks(const Config& config, Reporter& reporter);
+
+} // End namespace Benchmark
+#endif // End header guard
@@ -0,0 +1,96 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Benchmark.h"
+
+namespace
+{
+
+void
+printUsage(const char* name)
+{
+  std::cerr << "Usage: " << name << " [options]\n"
+            << "  --format csv|json     Output format (default csv)\n"
+            << "  --output <file>       Write results to a file instead of stdout\n"
+            << "  --max-threads <n>     Largest number of producers/consumers/readers (default hardware concurrency)\n"
+            << "  --items <n>           Items passed through a queue in each run (default 200000)\n"
+            << "  --duration-ms <n>     Length of each SearchRingBuffer run in milliseconds (default 200)\n"
+            << "  --queue-only          Only run the queue benchmarks\n"
+            << "  --ringbuffer-only     Only run the SearchRingBuffer benchmarks\n";
+}
+
+} // End anonymous namespace
+
+int
+main(int argc, char* argv[])
+{
+  Benchmark::Config           config{ std::max(2u, std::thread::hardware_concurrency()), 200000, std::chrono::milliseconds(200) };
+  Benchmark::Reporter::Format format{ Benchmark::Reporter::Format::Csv };
+  std::string                 outputPath;
+  bool                        runQueue{ true };
+  bool                        runRingBuffer{ true };
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    const bool        hasValue = i + 1 < argc;
+    if (arg == "--format" && hasValue)
+    {
+      const std::string value = argv[++i];
+      format = (value == "json") ? Benchmark::Reporter::Format::Json : Benchmark::Reporter::Format::Csv;
+    }
+    else if (arg == "--output" && hasValue)
+    {
+      outputPath = argv[++i];
+    }
+    else if (arg == "--max-threads" && hasValue)
+    {
+      config.maxThreads = std::stoul(argv[++i]);
+    }
+    else if (arg == "--items" && hasValue)
+    {
+      config.items = std::stoul(argv[++i]);
+    }
+    else if (arg == "--duration-ms" && hasValue)
+    {
+      config.duration = std::chrono::milliseconds(std::stoul(argv[++i]));
+    }
+    else if (arg == "--queue-only")
+    {
+      runRingBuffer = false;
+    }
+    else if (arg == "--ringbuffer-only")
+    {
+      runQueue = false;
+    }
+    else
+    {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  std::ofstream file;
+  if (!outputPath.empty())
+  {
+    file.open(outputPath);
+    if (!file)
+    {
+      std::cerr << "Unable to open " << outputPath << "\n";
+      return 1;
+    }
+  }
+
+  Benchmark::Reporter reporter(outputPath.empty() ? std::cout : file, format);
+  if (runQueue)
+  {
+    Benchmark::runQueueBenchmarks(config, reporter);
+  }
+  if (runRingBuffer)
+  {
+    Benchmark::runSearchRingBufferBenchmarks(config, reporter);
+  }
+  reporter.write();
+  return 0;
+}
@@ -0,0 +1,145 @@
+#include <array>
+#include <memory>
+#include <thread>
+
+#include "Benchmark.h"
+#include "ConcurrentBoundedQueue.h"
+#include "ConcurrentQueue.h"
+#include "ConcurrentSPSCQueue.h"
+
+namespace Benchmark
+{
+namespace
+{
+
+constexpr std::size_t boundedCapacity = 1024;
+
+// Item passed through the queue. Carries the time it was pushed so consumers can measure the latency.
+template<std::size_t Bytes>
+struct Payload
+{
+  static_assert(Bytes >= sizeof(clock::time_point), "Payload must be large enough for the time stamp");
+
+  clock::time_point                                   pushed;
+  std::array<char, Bytes - sizeof(clock::time_point)> padding;
+};
+
+enum class GetMode
+{
+  Wait, // waitGet()
+  Try   // Spin on tryGet()
+};
+
+// Pass config.items items from the producers to the consumers and time how long it takes.
+// Every item's latency from push to get is recorded.
+template<typename QueueType, std::size_t Bytes>
+Result
+runQueue(const std::string& name, std::size_t capacity, GetMode mode, std::size_t producers, std::size_t consumers, const Config& config)
+{
+  auto                         queue = std::make_unique<QueueType>();
+  const std::size_t            perProducer = config.items / producers;
+  const std::size_t            total = perProducer * producers;
+  StartGate                    gate;
+  std::vector<LatencyRecorder> recorders(consumers);
+  std::vector<std::thread>     threads;
+
+  for (std::size_t p = 0; p < producers; ++p)
+  {
+    threads.emplace_back([&queue, &gate, perProducer]() {
+      gate.wait();
+      for (std::size_t i = 0; i < perProducer; ++i)
+      {
+        queue->push(Payload<Bytes>{ clock::now(), {} });
+      }
+    });
+  }
+
+  for (std::size_t c = 0; c < consumers; ++c)
+  {
+    // Split the items between consumers, giving the remainder to the first consumer
+    const std::size_t count = total / consumers + (c == 0 ? total % consumers : 0);
+    threads.emplace_back([&queue, &gate, &recorder = recorders[c], count, mode]() {
+      recorder.reserve(count);
+      gate.wait();
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        if (mode == GetMode::Wait)
+        {
+          recorder.record(clock::now() - queue->waitGet().pushed);
+        }
+        else
+        {
+          std::optional<Payload<Bytes>> item;
+          while (!(item = queue->tryGet()))
+          {
+            Concurrent::cpuRelax();
+          }
+          recorder.record(clock::now() - item->pushed);
+        }
+      }
+    });
+  }
+
+  const auto start = clock::now();
+  gate.open();
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  const std::chrono::duration<double> elapsed = clock::now() - start;
+
+  LatencyRecorder latency;
+  for (const auto& recorder : recorders)
+  {
+    latency.merge(recorder);
+  }
+
+  return Result{ name,
+                 mode == GetMode::Wait ? "push/waitGet" : "push/tryGet",
+                 producers,
+                 consumers,
+                 Bytes,
+                 capacity,
+                 static_cast<double>(total) / elapsed.count(),
+                 latency.percentile(0.5),
+                 latency.percentile(0.99),
+                 latency.percentile(0.999) };
+}
+
+template<std::size_t Bytes>
+void
+runPayload(const Config& config, Reporter& reporter)
+{
+  using Item = Payload<Bytes>;
+
+  for (auto producers : threadCounts(config.maxThreads))
+  {
+    for (auto consumers : threadCounts(config.maxThreads))
+    {
+      reporter.add(runQueue<Concurrent::Queue<Item>, Bytes>("Queue", 0, GetMode::Wait, producers, consumers, config));
+      reporter.add(runQueue<Concurrent::Queue<Item>, Bytes>("Queue", 0, GetMode::Try, producers, consumers, config));
+      reporter.add(runQueue<Concurrent::Queue<Item, std::deque<Item>, Concurrent::SpinThenBlockWait<>>, Bytes>(
+        "Queue<SpinThenBlockWait>", 0, GetMode::Wait, producers, consumers, config));
+      reporter.add(runQueue<Concurrent::BoundedQueue<Item, boundedCapacity>, Bytes>(
+        "BoundedQueue", boundedCapacity, GetMode::Wait, producers, consumers, config));
+      reporter.add(runQueue<Concurrent::BoundedQueue<Item, boundedCapacity>, Bytes>(
+        "BoundedQueue", boundedCapacity, GetMode::Try, producers, consumers, config));
+    }
+  }
+
+  // Only valid with one producer and one consumer
+  reporter.add(runQueue<Concurrent::SPSCQueue<Item, boundedCapacity>, Bytes>("SPSCQueue", boundedCapacity, GetMode::Wait, 1, 1, config));
+  reporter.add(runQueue<Concurrent::SPSCQueue<Item, boundedCapacity>, Bytes>("SPSCQueue", boundedCapacity, GetMode::Try, 1, 1, config));
+}
+
+} // End anonymous namespace
+
+void
+runQueueBenchmarks(const Config& config, Reporter& reporter)
+{
+  runPayload<16>(config, reporter);
+  runPayload<64>(config, reporter);
+  runPayload<256>(config, reporter);
+}
+
+} // End namespace Benchmark
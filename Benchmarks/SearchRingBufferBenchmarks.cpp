@@ -0,0 +1,150 @@
+#include <memory>
+#include <random>
+#include <thread>
+#include <type_traits>
+
+#include "Benchmark.h"
+#include "SearchRingBuffer.h"
+#include "SeqLockSearchRingBuffer.h"
+
+namespace Benchmark
+{
+namespace
+{
+
+using sysClock = std::chrono::system_clock;
+
+// Only every Nth read is timed individually to keep the cost of reading the clock out of the throughput figure
+constexpr std::size_t latencySampleRate = 16;
+
+// Run time sized buffers take their capacity in the constructor
+template<typename Buffer, std::size_t SIZE>
+std::unique_ptr<Buffer>
+makeBuffer()
+{
+  if constexpr (std::is_constructible_v<Buffer, std::size_t>)
+  {
+    return std::make_unique<Buffer>(SIZE);
+  }
+  else
+  {
+    return std::make_unique<Buffer>(); // Large buffers would overflow the stack
+  }
+}
+
+// One producer pushes continuously while the readers look up random times within the buffered window.
+// Reports the read throughput and latency, and the push throughput achieved while the readers were running.
+template<typename Buffer, std::size_t SIZE>
+void
+runBuffer(const std::string& name, std::size_t readers, const Config& config, Reporter& reporter)
+{
+  auto                         buffer = makeBuffer<Buffer, SIZE>();
+  const auto                   base = sysClock::now();
+  std::atomic<std::int64_t>    pushed{ 0 };
+  std::atomic<bool>            stop{ false };
+  StartGate                    gate;
+  std::vector<LatencyRecorder> recorders(readers);
+  std::vector<std::size_t>     readCounts(readers, 0);
+  std::vector<std::thread>     threads;
+
+  // Fill the buffer so every read has a full window to search
+  for (std::size_t i = 0; i < SIZE; ++i)
+  {
+    buffer->push(base + std::chrono::microseconds(i), static_cast<std::int64_t>(i));
+  }
+  pushed = SIZE;
+
+  threads.emplace_back([&]() {
+    gate.wait();
+    std::int64_t next = pushed.load(std::memory_order_relaxed);
+    while (!stop.load(std::memory_order_relaxed))
+    {
+      buffer->push(base + std::chrono::microseconds(next), next);
+      pushed.store(++next, std::memory_order_relaxed);
+    }
+  });
+
+  for (std::size_t r = 0; r < readers; ++r)
+  {
+    threads.emplace_back([&, r]() {
+      std::mt19937_64                             generator(r);
+      std::uniform_int_distribution<std::int64_t> offset(0, SIZE - 1);
+      std::size_t                                 count{ 0 };
+      gate.wait();
+      while (!stop.load(std::memory_order_relaxed))
+      {
+        const auto requested = base + std::chrono::microseconds(pushed.load(std::memory_order_relaxed) - 1 - offset(generator));
+        if (count % latencySampleRate == 0)
+        {
+          const auto start = clock::now();
+          buffer->read(requested);
+          recorders[r].record(clock::now() - start);
+        }
+        else
+        {
+          buffer->read(requested);
+        }
+        ++count;
+      }
+      readCounts[r] = count;
+    });
+  }
+
+  const auto start = clock::now();
+  const auto startPushed = pushed.load();
+  gate.open();
+  std::this_thread::sleep_for(config.duration);
+  stop = true;
+  const auto endPushed = pushed.load();
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  const std::chrono::duration<double> elapsed = clock::now() - start;
+
+  LatencyRecorder latency;
+  std::size_t     reads{ 0 };
+  for (std::size_t r = 0; r < readers; ++r)
+  {
+    latency.merge(recorders[r]);
+    reads += readCounts[r];
+  }
+
+  reporter.add(Result{ name,
+                       "read",
+                       1,
+                       readers,
+                       sizeof(std::int64_t),
+                       SIZE,
+                       static_cast<double>(reads) / elapsed.count(),
+                       latency.percentile(0.5),
+                       latency.percentile(0.99),
+                       latency.percentile(0.999) });
+  reporter.add(Result{ name, "push", 1, readers, sizeof(std::int64_t), SIZE, static_cast<double>(endPushed - startPushed) / elapsed.count(), 0, 0, 0 });
+}
+
+template<std::size_t SIZE>
+void
+runSize(const Config& config, Reporter& reporter)
+{
+  for (auto readers : threadCounts(config.maxThreads))
+  {
+    runBuffer<Concurrent::SearchRingBuffer<std::int64_t, SIZE>, SIZE>("SearchRingBuffer", readers, config, reporter);
+    runBuffer<Concurrent::SearchRingBuffer<std::int64_t, SIZE, Concurrent::InterpolationSearch<>>, SIZE>(
+      "SearchRingBuffer<InterpolationSearch>", readers, config, reporter);
+    runBuffer<Concurrent::DynamicSearchRingBuffer<std::int64_t>, SIZE>("DynamicSearchRingBuffer", readers, config, reporter);
+    runBuffer<Concurrent::SeqLockSearchRingBuffer<std::int64_t, SIZE>, SIZE>("SeqLockSearchRingBuffer", readers, config, reporter);
+  }
+}
+
+} // End anonymous namespace
+
+void
+runSearchRingBufferBenchmarks(const Config& config, Reporter& reporter)
+{
+  runSize<1024>(config, reporter);
+  runSize<65536>(config, reporter);
+  runSize<1048576>(config, reporter);
+}
+
+} // End namespace Benchmark
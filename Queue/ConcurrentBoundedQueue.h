@@ -0,0 +1,248 @@
+#ifndef CONCURRENT_BOUNDEDQUEUE_H
+#define CONCURRENT_BOUNDEDQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+#include "SlotSequence.h"
+
+namespace Concurrent
+{
+
+// Fixed capacity multi producer / multi consumer queue.
+// Each slot carries a sequence number which tells producers and consumers whether the slot is ready for them (see
+// SlotSequence.h), so push() and tryGet() only need a single compare-and-swap on the uncontended path.
+// The mutex and condition variables are only used when a caller has to block because the ring is full or empty.
+template<typename T, std::size_t Capacity>
+class BoundedQueue
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "BoundedQueue capacity must be a power of two");
+  // Once a slot is claimed it must be published or released, so nothing may throw while an object is moved in or out
+  static_assert(std::is_nothrow_move_constructible_v<T>, "BoundedQueue data must be nothrow move constructible");
+
+public:
+  BoundedQueue();
+  BoundedQueue(const BoundedQueue&) = delete;            // Disable copying of the class
+  BoundedQueue& operator=(const BoundedQueue&) = delete; // Disable assignment of the class
+  ~BoundedQueue();
+
+  void             push(const T& object);
+  void             push(T&& object);
+  bool             tryPush(const T& object);
+  bool             tryPush(T&& object);
+  T                waitGet();
+  std::optional<T> tryGet();
+  bool             isEmpty() const;
+
+private:
+  static constexpr std::size_t cacheLineSize = 64;
+  using Sequence = Detail::SlotSequence<Capacity>;
+
+  struct Slot
+  {
+    std::atomic<std::size_t>                      sequence; // Position this slot is next ready for
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;  // Uninitialised storage for the object
+  };
+
+  alignas(cacheLineSize) std::atomic<std::size_t> mEnqueuePos; // Next position a producer will claim
+  alignas(cacheLineSize) std::atomic<std::size_t> mDequeuePos; // Next position a consumer will claim
+  alignas(cacheLineSize) std::array<Slot, Capacity> mSlots;    // Underlying ring
+
+  // Slow path state. Only touched when a producer finds the ring full or a consumer finds it empty.
+  std::mutex               mMutex;
+  std::condition_variable  mNotEmpty;
+  std::condition_variable  mNotFull;
+  std::atomic<std::size_t> mWaitingConsumers{ 0 };
+  std::atomic<std::size_t> mWaitingProducers{ 0 };
+
+  template<typename U>
+  bool             enqueue(U&& object); // Constructing T from object must not throw
+  std::optional<T> dequeue();
+
+  // Wake a blocked thread, but only pay for the mutex if somebody is actually waiting.
+  void notify(std::atomic<std::size_t>& waiters, std::condition_variable& conVar);
+};
+
+template<typename T, std::size_t Capacity>
+BoundedQueue<T, Capacity>::BoundedQueue() : mEnqueuePos(0), mDequeuePos(0)
+{
+  Sequence::initialise(mSlots.data());
+}
+
+template<typename T, std::size_t Capacity>
+BoundedQueue<T, Capacity>::~BoundedQueue()
+{
+  // Destroy any objects which were never consumed
+  while (dequeue())
+  {
+  }
+}
+
+template<typename T, std::size_t Capacity>
+void
+BoundedQueue<T, Capacity>::push(const T& object)
+{
+  if constexpr (!std::is_nothrow_copy_constructible_v<T>) // Copy before claiming a slot, then move the copy in
+  {
+    push(T(object));
+  }
+  else
+  {
+    if (!enqueue(object))
+    {
+      std::unique_lock uniqueLock(mMutex);
+      mWaitingProducers.fetch_add(1);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      mNotFull.wait(uniqueLock, [this, &object] { return enqueue(object); });
+      mWaitingProducers.fetch_sub(1);
+    }
+    notify(mWaitingConsumers, mNotEmpty);
+  }
+}
+
+template<typename T, std::size_t Capacity>
+void
+BoundedQueue<T, Capacity>::push(T&& object)
+{
+  if (!enqueue(std::move(object)))
+  {
+    std::unique_lock uniqueLock(mMutex);
+    mWaitingProducers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // enqueue() only moves from the object once it has claimed a slot, so retrying with the same object is safe.
+    mNotFull.wait(uniqueLock, [this, &object] { return enqueue(std::move(object)); });
+    mWaitingProducers.fetch_sub(1);
+  }
+  notify(mWaitingConsumers, mNotEmpty);
+}
+
+template<typename T, std::size_t Capacity>
+bool
+BoundedQueue<T, Capacity>::tryPush(const T& object)
+{
+  if constexpr (!std::is_nothrow_copy_constructible_v<T>) // Copy before claiming a slot, then move the copy in
+  {
+    return tryPush(T(object));
+  }
+  else
+  {
+    if (enqueue(object))
+    {
+      notify(mWaitingConsumers, mNotEmpty);
+      return true;
+    }
+    return false;
+  }
+}
+
+template<typename T, std::size_t Capacity>
+bool
+BoundedQueue<T, Capacity>::tryPush(T&& object)
+{
+  if (enqueue(std::move(object)))
+  {
+    notify(mWaitingConsumers, mNotEmpty);
+    return true;
+  }
+  return false;
+}
+
+template<typename T, std::size_t Capacity>
+T
+BoundedQueue<T, Capacity>::waitGet()
+{
+  std::optional<T> object = tryGet();
+  if (!object)
+  {
+    std::unique_lock uniqueLock(mMutex);
+    mWaitingConsumers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    mNotEmpty.wait(uniqueLock, [this, &object] { return (object = dequeue()).has_value(); });
+    mWaitingConsumers.fetch_sub(1);
+    uniqueLock.unlock();
+    notify(mWaitingProducers, mNotFull);
+  }
+  return std::move(*object);
+}
+
+template<typename T, std::size_t Capacity>
+std::optional<T>
+BoundedQueue<T, Capacity>::tryGet()
+{
+  std::optional<T> object = dequeue();
+  if (object)
+  {
+    notify(mWaitingProducers, mNotFull);
+  }
+  return object;
+}
+
+template<typename T, std::size_t Capacity>
+bool
+BoundedQueue<T, Capacity>::isEmpty() const
+{
+  return Sequence::isEmpty(mDequeuePos, mSlots.data());
+}
+
+template<typename T, std::size_t Capacity>
+template<typename U>
+bool
+BoundedQueue<T, Capacity>::enqueue(U&& object)
+{
+  static_assert(std::is_nothrow_constructible_v<T, U&&>, "A claimed slot would never be published if constructing the object threw");
+
+  std::size_t pos;
+  Slot* const slot = Sequence::claimPush(mEnqueuePos, mSlots.data(), pos);
+  if (slot == nullptr)
+  {
+    return false;
+  }
+
+  new (&slot->storage) T(std::forward<U>(object));
+  Sequence::publishPush(*slot, pos);
+  return true;
+}
+
+template<typename T, std::size_t Capacity>
+std::optional<T>
+BoundedQueue<T, Capacity>::dequeue()
+{
+  std::size_t pos;
+  Slot* const slot = Sequence::claimPop(mDequeuePos, mSlots.data(), pos);
+  if (slot == nullptr)
+  {
+    return std::nullopt;
+  }
+
+  T*               stored = std::launder(reinterpret_cast<T*>(&slot->storage));
+  std::optional<T> object(std::move(*stored));
+  stored->~T();
+  Sequence::releasePop(*slot, pos);
+  return object;
+}
+
+// The fence pairs with the fence a blocking thread issues between incrementing the waiter count and retrying its operation.
+// Either the waiter sees the slot we just published/released, or we see the waiter count and take the mutex so the
+// notify cannot fall between the waiter's check and its wait.
+template<typename T, std::size_t Capacity>
+void
+BoundedQueue<T, Capacity>::notify(std::atomic<std::size_t>& waiters, std::condition_variable& conVar)
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiters.load(std::memory_order_relaxed) != 0)
+  {
+    {
+      std::scoped_lock scopedLock(mMutex);
+    }
+    conVar.notify_one();
+  }
+}
+
+} // End namespace Concurrent
+#endif // End header guard
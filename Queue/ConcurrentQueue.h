@@ -1,45 +1,130 @@
 #ifndef CONCURRENT_QUEUE_H
 #define CONCURRENT_QUEUE_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <iterator>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <stdexcept>
+#include <vector>
+
+#include "QueueStats.h"
+#include "WaitPolicy.h"
 
 namespace Concurrent
 {
 
-template<typename T, class Container = std::deque<T>>
-class Queue
+// WaitPolicy decides what waiting consumers do before blocking on the condition variable. See WaitPolicy.h
+// StatsPolicy decides whether the queue counts its activity for stats(). See QueueStats.h
+// The policy is a private base so the default NoQueueStats takes up no space.
+template<typename T, class Container = std::deque<T>, class WaitPolicy = BlockingWait, class StatsPolicy = NoQueueStats>
+class Queue : private StatsPolicy
 {
 public:
   Queue() = default;
   Queue(const Queue& other);
-  Queue<T>& operator=(const Queue& other);
+  Queue& operator=(const Queue& other);
   ~Queue() = default;
 
-  void             push(const T& object);
-  void             push(T&& object);
+  // Pushing to a closed queue fails and returns false
+  bool             push(const T& object);
+  bool             push(T&& object);
+  bool             push(std::vector<T>&& objects);
+
+  // Construct the object directly in the queue from args
+  template<typename... Args>
+  bool emplace(Args&&... args);
+
   T                waitGet();
   std::optional<T> tryGet();
   bool             isEmpty() const;
 
+  // Stop accepting new data and wake every waiting consumer.
+  // Consumers can still retrieve the data already in the queue. Once it is drained waiting functions return immediately.
+  void close();
+  bool isClosed() const;
+
+  // Wait until an element is available or the timeout expires. Returns std::nullopt on timeout or if the queue is closed and empty.
+  template<typename Rep, typename Period>
+  std::optional<T> waitGetFor(const std::chrono::duration<Rep, Period>& timeout);
+  template<typename Clock, typename Duration>
+  std::optional<T> waitGetUntil(const std::chrono::time_point<Clock, Duration>& deadline);
+
+  // Insert every element of [first, last) under a single lock acquisition.
+  template<typename InputIt>
+  bool pushRange(InputIt first, InputIt last);
+
+  // Move up to maxCount elements to out under a single lock acquisition. Returns the number of elements retrieved.
+  // tryGetBulk() returns 0 immediately if the queue is empty, waitGetBulk() waits until at least one element is available
+  // and only returns 0 once the queue is closed and empty.
+  template<typename OutputIt>
+  std::size_t tryGetBulk(OutputIt out, std::size_t maxCount);
+  template<typename OutputIt>
+  std::size_t waitGetBulk(OutputIt out, std::size_t maxCount);
+
+  // Snapshot of the counters, taken under the queue's lock so they are consistent with each other.
+  // Only available with a StatsPolicy which keeps statistics, such as CountQueueStats.
+  QueueStats stats() const;
+
+  // Exceptions
+  class Closed : public std::runtime_error
+  {
+  public:
+    Closed() : runtime_error("Error trying to get data from a closed and empty queue") {}
+  };
+
 private:
   mutable std::mutex       mMutex;
   std::queue<T, Container> mQueue;
   std::condition_variable  mConVar;
+  std::atomic<bool>        mClosed{ false }; // Set once close() is called. No data can be pushed afterwards. Written under mMutex.
+  std::atomic<std::size_t> mSize{ 0 };       // Copy of mQueue.size() which waiting consumers can spin on without the lock
+  std::size_t              mWaiters{ 0 };    // Number of consumers blocked on mConVar. Protected by mMutex.
+
+  // Must be called with mMutex held after any change to mQueue
+  void updateSize() { mSize.store(mQueue.size(), std::memory_order_relaxed); }
+
+  // Record and announce the count items pushRange() added, then release the lock
+  void finishPushRange(std::unique_lock<std::mutex>& uniqueLock, const std::size_t count);
+
+  // Must be called without mMutex held, before blocking on mConVar. Stops as soon as there is data, the queue is closed
+  // or the deadline passes, so a consumer which would not block does not spin either.
+  bool hasDataOrClosed() const { return mSize.load(std::memory_order_relaxed) != 0 || mClosed.load(std::memory_order_relaxed); }
+  void spinForData() { WaitPolicy::spin([this] { return hasDataOrClosed(); }); }
+  template<typename Clock, typename Duration>
+  void
+  spinForData(const std::chrono::time_point<Clock, Duration>& deadline)
+  {
+    WaitPolicy::spin([this, &deadline] { return hasDataOrClosed() || !(Clock::now() < deadline); });
+  }
+
+  // Must be called with mMutex held. Calls block(ready) to block on mConVar until there is data or the queue is closed,
+  // timing the wait for the stats if the consumer actually blocks.
+  template<typename Block>
+  void waitForData(Block&& block);
+
+  // Must be called with mMutex held
+  template<typename OutputIt>
+  std::size_t popBulk(OutputIt out, std::size_t maxCount);
 };
 
-template<typename T, class Container>
-Queue<T, Container>::Queue(const Queue& other)
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+Queue<T, Container, WaitPolicy, StatsPolicy>::Queue(const Queue& other)
 {
   std::scoped_lock scopedLock(other.mMutex);
   mQueue = other.mQueue;
+  mClosed.store(other.mClosed.load());
+  updateSize();
 }
 
-template<typename T, class Container>
-Queue<T>&
-Queue<T, Container>::operator=(const Queue& other)
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+Queue<T, Container, WaitPolicy, StatsPolicy>&
+Queue<T, Container, WaitPolicy, StatsPolicy>::operator=(const Queue& other)
 {
   // Check for self assignment
   if (this != &other)
@@ -50,66 +135,165 @@ Queue<T, Container>::operator=(const Queue& other)
     std::lock(unique_lock, other_unique_lock);
 
     mQueue = other.mQueue;
+    mClosed.store(other.mClosed.load());
+    updateSize();
   }
   return *this;
 }
 
-template<typename T, class Container>
-void
-Queue<T, Container>::push(const T& object)
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+bool
+Queue<T, Container, WaitPolicy, StatsPolicy>::push(const T& object)
+{
+  return emplace(object);
+}
+
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+bool
+Queue<T, Container, WaitPolicy, StatsPolicy>::push(T&& object)
+{
+  return emplace(std::move(object));
+}
+
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+template<typename... Args>
+bool
+Queue<T, Container, WaitPolicy, StatsPolicy>::emplace(Args&&... args)
 {
   std::unique_lock uniqueLock(mMutex);
-  const bool       was_empty = mQueue.empty();
+  if (mClosed.load(std::memory_order_relaxed))
+  {
+    return false;
+  }
 
-  mQueue.push(object);
+  mQueue.emplace(std::forward<Args>(args)...);
+  updateSize();
+  StatsPolicy::onPush(1, mQueue.size());
 
-  // If the queue was empty there may be some consumers waiting for data.
-  if (was_empty)
+  // Only notify if a consumer is actually waiting. This is checked on every push rather than only when the queue was
+  // empty so a burst of pushes wakes one waiting consumer per item instead of leaving the others asleep.
+  if (mWaiters != 0)
   {
     // Unlock mutex before notifying so waiting threads do not have to wait for the mutex after being woken.
     uniqueLock.unlock();
     mConVar.notify_one();
   }
+  return true;
 }
 
-template<typename T, class Container>
-void
-Queue<T, Container>::push(T&& object)
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+bool
+Queue<T, Container, WaitPolicy, StatsPolicy>::push(std::vector<T>&& objects)
+{
+  // The elements are left untouched if the queue is closed
+  if (!pushRange(std::make_move_iterator(objects.begin()), std::make_move_iterator(objects.end())))
+  {
+    return false;
+  }
+  objects.clear();
+  return true;
+}
+
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+template<typename InputIt>
+bool
+Queue<T, Container, WaitPolicy, StatsPolicy>::pushRange(InputIt first, InputIt last)
 {
   std::unique_lock uniqueLock(mMutex);
-  const bool       was_empty = mQueue.empty();
+  if (mClosed.load(std::memory_order_relaxed))
+  {
+    return false;
+  }
+  std::size_t count{ 0 };
+  try
+  {
+    for (; first != last; ++first, ++count)
+    {
+      mQueue.push(*first);
+    }
+  }
+  catch (...) // The items pushed before the failure stay in the queue, so consumers must still see them
+  {
+    finishPushRange(uniqueLock, count);
+    throw;
+  }
+  finishPushRange(uniqueLock, count);
+  return true;
+}
 
-  mQueue.push(std::move(object));
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+void
+Queue<T, Container, WaitPolicy, StatsPolicy>::finishPushRange(std::unique_lock<std::mutex>& uniqueLock, const std::size_t count)
+{
+  updateSize();
+  StatsPolicy::onPush(count, mQueue.size());
 
-  // If the queue was empty there may be some consumers waiting for data.
-  if (was_empty)
+  // Wake one waiting consumer per item pushed, up to the number of consumers waiting.
+  const std::size_t toWake = std::min(count, mWaiters);
+  uniqueLock.unlock();
+  for (std::size_t i = 0; i < toWake; ++i)
   {
-    // Unlock mutex before notifying so waiting threads do not have to wait for the mutex after being woken.
-    uniqueLock.unlock();
     mConVar.notify_one();
   }
 }
 
-template<typename T, class Container>
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
 T
-Queue<T, Container>::waitGet()
+Queue<T, Container, WaitPolicy, StatsPolicy>::waitGet()
+{
+  spinForData();
+  std::unique_lock uniqueLock(mMutex);
+  waitForData([&uniqueLock, this](auto ready) { mConVar.wait(uniqueLock, ready); });
+  if (mQueue.empty()) // Closed and drained so there is nothing to return
+  {
+    throw Closed{};
+  }
+  T object = std::move(mQueue.front());
+  mQueue.pop();
+  updateSize();
+  StatsPolicy::onPop(1);
+  return object;
+}
+
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+template<typename Rep, typename Period>
+std::optional<T>
+Queue<T, Container, WaitPolicy, StatsPolicy>::waitGetFor(const std::chrono::duration<Rep, Period>& timeout)
+{
+  // Convert to a deadline up front so spurious wake-ups do not extend the total wait
+  return waitGetUntil(Detail::deadlineAfter(timeout));
+}
+
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+template<typename Clock, typename Duration>
+std::optional<T>
+Queue<T, Container, WaitPolicy, StatsPolicy>::waitGetUntil(const std::chrono::time_point<Clock, Duration>& deadline)
 {
+  spinForData(deadline);
   std::unique_lock uniqueLock(mMutex);
-  mConVar.wait(uniqueLock, [this] { return !mQueue.empty(); });
+  waitForData([&uniqueLock, &deadline, this](auto ready) { mConVar.wait_until(uniqueLock, deadline, ready); });
+  if (mQueue.empty()) // Timed out, or closed and drained
+  {
+    return std::nullopt;
+  }
   T object = std::move(mQueue.front());
   mQueue.pop();
+  updateSize();
+  StatsPolicy::onPop(1);
   return object;
 }
 
-template<typename T, class Container>
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
 std::optional<T>
-Queue<T, Container>::tryGet()
+Queue<T, Container, WaitPolicy, StatsPolicy>::tryGet()
 {
   std::scoped_lock scopedLock(mMutex);
   if (!mQueue.empty())
   {
     T object = std::move(mQueue.front());
     mQueue.pop();
+    updateSize();
+    StatsPolicy::onPop(1);
     return object;
   }
   else
@@ -118,13 +302,108 @@ Queue<T, Container>::tryGet()
   }
 }
 
-template<typename T, class Container>
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
 bool
-Queue<T, Container>::isEmpty() const
+Queue<T, Container, WaitPolicy, StatsPolicy>::isEmpty() const
 {
   std::scoped_lock scopedLock(mMutex);
   return mQueue.empty();
 }
 
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+void
+Queue<T, Container, WaitPolicy, StatsPolicy>::close()
+{
+  {
+    std::scoped_lock scopedLock(mMutex);
+    mClosed.store(true, std::memory_order_relaxed);
+  }
+  // Every waiting consumer has to re-check the queue, not just one
+  mConVar.notify_all();
+}
+
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+bool
+Queue<T, Container, WaitPolicy, StatsPolicy>::isClosed() const
+{
+  std::scoped_lock scopedLock(mMutex);
+  return mClosed.load(std::memory_order_relaxed);
+}
+
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+template<typename OutputIt>
+std::size_t
+Queue<T, Container, WaitPolicy, StatsPolicy>::tryGetBulk(OutputIt out, std::size_t maxCount)
+{
+  std::scoped_lock scopedLock(mMutex);
+  return popBulk(out, maxCount);
+}
+
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+template<typename OutputIt>
+std::size_t
+Queue<T, Container, WaitPolicy, StatsPolicy>::waitGetBulk(OutputIt out, std::size_t maxCount)
+{
+  if (maxCount == 0)
+  {
+    return 0;
+  }
+
+  spinForData();
+  std::unique_lock uniqueLock(mMutex);
+  waitForData([&uniqueLock, this](auto ready) { mConVar.wait(uniqueLock, ready); });
+  return popBulk(out, maxCount);
+}
+
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+template<typename OutputIt>
+std::size_t
+Queue<T, Container, WaitPolicy, StatsPolicy>::popBulk(OutputIt out, std::size_t maxCount)
+{
+  std::size_t count{ 0 };
+  while (count < maxCount && !mQueue.empty())
+  {
+    *out = std::move(mQueue.front());
+    ++out;
+    mQueue.pop();
+    ++count;
+  }
+  updateSize();
+  StatsPolicy::onPop(count);
+  return count;
+}
+
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+template<typename Block>
+void
+Queue<T, Container, WaitPolicy, StatsPolicy>::waitForData(Block&& block)
+{
+  const auto ready = [this] { return !mQueue.empty() || mClosed.load(std::memory_order_relaxed); };
+  ++mWaiters;
+  if constexpr (StatsPolicy::enabled)
+  {
+    if (!ready()) // Only a consumer which has to block counts as a wait
+    {
+      const auto start = std::chrono::steady_clock::now();
+      block(ready);
+      StatsPolicy::onWait(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start));
+    }
+  }
+  else
+  {
+    block(ready);
+  }
+  --mWaiters;
+}
+
+template<typename T, class Container, class WaitPolicy, class StatsPolicy>
+QueueStats
+Queue<T, Container, WaitPolicy, StatsPolicy>::stats() const
+{
+  static_assert(StatsPolicy::enabled, "stats() needs a StatsPolicy which keeps statistics, such as CountQueueStats");
+  std::scoped_lock scopedLock(mMutex);
+  return StatsPolicy::snapshot();
+}
+
 } // End namespace Concurrent
 #endif // End header guard
\ No newline at end of file
@@ -0,0 +1,170 @@
+#ifndef CONCURRENT_SPSCQUEUE_H
+#define CONCURRENT_SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+namespace Concurrent
+{
+
+// Fixed capacity queue for exactly one producer thread and one consumer thread.
+// The producer only writes mTail and the consumer only writes mHead, so tryPush() and tryGet() are wait-free.
+// Each side keeps a private copy of the other side's index and only reloads it when the copy says the queue is full/empty,
+// which means the shared cache lines are rarely touched on the fast path.
+template<typename T, std::size_t Capacity>
+class SPSCQueue
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SPSCQueue capacity must be a power of two");
+
+public:
+  SPSCQueue() = default;
+  SPSCQueue(const SPSCQueue&) = delete;            // Disable copying of the class
+  SPSCQueue& operator=(const SPSCQueue&) = delete; // Disable assignment of the class
+  ~SPSCQueue();
+
+  // Producer thread only
+  void push(const T& object);
+  void push(T&& object);
+  bool tryPush(const T& object);
+  bool tryPush(T&& object);
+
+  // Consumer thread only
+  T                waitGet();
+  std::optional<T> tryGet();
+
+  bool isEmpty() const;
+
+private:
+  static constexpr std::size_t cacheLineSize = 64;
+  static constexpr std::size_t indexMask = Capacity - 1;
+
+  using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+  // Consumer owned cache line
+  alignas(cacheLineSize) std::atomic<std::size_t> mHead{ 0 }; // Next position to read
+  std::size_t mCachedTail{ 0 };                               // Consumer's last seen value of mTail
+
+  // Producer owned cache line
+  alignas(cacheLineSize) std::atomic<std::size_t> mTail{ 0 }; // Next position to write
+  std::size_t mCachedHead{ 0 };                               // Producer's last seen value of mHead
+
+  alignas(cacheLineSize) std::array<Storage, Capacity> mSlots; // Underlying ring
+
+  template<typename U>
+  bool enqueue(U&& object);
+
+  T* slot(std::size_t pos) { return std::launder(reinterpret_cast<T*>(&mSlots[pos & indexMask])); }
+};
+
+template<typename T, std::size_t Capacity>
+SPSCQueue<T, Capacity>::~SPSCQueue()
+{
+  // Destroy any objects which were never consumed
+  for (std::size_t pos = mHead.load(std::memory_order_relaxed); pos != mTail.load(std::memory_order_relaxed); ++pos)
+  {
+    slot(pos)->~T();
+  }
+}
+
+template<typename T, std::size_t Capacity>
+void
+SPSCQueue<T, Capacity>::push(const T& object)
+{
+  while (!enqueue(object))
+  {
+    std::this_thread::yield();
+  }
+}
+
+template<typename T, std::size_t Capacity>
+void
+SPSCQueue<T, Capacity>::push(T&& object)
+{
+  // enqueue() only moves from the object once there is room, so retrying with the same object is safe.
+  while (!enqueue(std::move(object)))
+  {
+    std::this_thread::yield();
+  }
+}
+
+template<typename T, std::size_t Capacity>
+bool
+SPSCQueue<T, Capacity>::tryPush(const T& object)
+{
+  return enqueue(object);
+}
+
+template<typename T, std::size_t Capacity>
+bool
+SPSCQueue<T, Capacity>::tryPush(T&& object)
+{
+  return enqueue(std::move(object));
+}
+
+template<typename T, std::size_t Capacity>
+T
+SPSCQueue<T, Capacity>::waitGet()
+{
+  std::optional<T> object;
+  while (!(object = tryGet()))
+  {
+    std::this_thread::yield();
+  }
+  return std::move(*object);
+}
+
+template<typename T, std::size_t Capacity>
+std::optional<T>
+SPSCQueue<T, Capacity>::tryGet()
+{
+  const std::size_t head = mHead.load(std::memory_order_relaxed);
+  if (head == mCachedTail)
+  {
+    mCachedTail = mTail.load(std::memory_order_acquire);
+    if (head == mCachedTail)
+    {
+      return std::nullopt;
+    }
+  }
+
+  T*               stored = slot(head);
+  std::optional<T> object(std::move(*stored));
+  stored->~T();
+  mHead.store(head + 1, std::memory_order_release);
+  return object;
+}
+
+template<typename T, std::size_t Capacity>
+bool
+SPSCQueue<T, Capacity>::isEmpty() const
+{
+  return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+}
+
+template<typename T, std::size_t Capacity>
+template<typename U>
+bool
+SPSCQueue<T, Capacity>::enqueue(U&& object)
+{
+  const std::size_t tail = mTail.load(std::memory_order_relaxed);
+  if (tail - mCachedHead == Capacity)
+  {
+    mCachedHead = mHead.load(std::memory_order_acquire);
+    if (tail - mCachedHead == Capacity)
+    {
+      return false;
+    }
+  }
+
+  new (&mSlots[tail & indexMask]) T(std::forward<U>(object));
+  mTail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+} // End namespace Concurrent
+#endif // End header guard
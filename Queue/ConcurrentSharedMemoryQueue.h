@@ -0,0 +1,318 @@
+#ifndef CONCURRENT_SHAREDMEMORYQUEUE_H
+#define CONCURRENT_SHAREDMEMORYQUEUE_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SlotSequence.h"
+#include "WaitPolicy.h"
+
+namespace Concurrent
+{
+
+// Fixed capacity multi producer / multi consumer queue which lives in POSIX shared memory, so producers and consumers
+// can be in different processes on the same host. It is the same slot sequence ring as BoundedQueue, without the mutex and
+// condition variables, which cannot be shared between processes safely. push(), waitGet() and waitGetFor() yield while the
+// ring is full or empty, so a waiting thread keeps a core busy for as long as it waits. Use waitGetFor() to bound that.
+// Objects are copied into and out of the shared memory, so T must be trivially copyable.
+template<typename T, std::size_t Capacity>
+class SharedMemoryQueue
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SharedMemoryQueue capacity must be a power of two");
+  static_assert(std::is_trivially_copyable_v<T>, "SharedMemoryQueue data must be trivially copyable");
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "SharedMemoryQueue needs lock free atomics to share them between processes");
+
+public:
+  // Open the shared memory queue called name (e.g. "/prices"), creating it if no process has yet.
+  // Every process must use the same T and Capacity. The queue lasts until remove() is called, even when no process has it open.
+  // If another process is creating the queue, wait up to setupTimeout for it to finish, then throw IncompatibleQueue.
+  explicit SharedMemoryQueue(const std::string& name, std::chrono::milliseconds setupTimeout = std::chrono::seconds(1));
+  SharedMemoryQueue(const SharedMemoryQueue&) = delete;            // Disable copying of the class
+  SharedMemoryQueue& operator=(const SharedMemoryQueue&) = delete; // Disable assignment of the class
+  ~SharedMemoryQueue();
+
+  // Delete the shared memory queue called name. Processes which have it open can carry on using it.
+  static void remove(const std::string& name);
+
+  void             push(const T& object);
+  bool             tryPush(const T& object);
+  T                waitGet();
+  std::optional<T> tryGet();
+  bool             isEmpty() const;
+
+  // Wait up to timeout for an object. Returns std::nullopt if none arrived in time.
+  template<typename Rep, typename Period>
+  std::optional<T> waitGetFor(const std::chrono::duration<Rep, Period>& timeout);
+
+  // Exceptions
+  class IncompatibleQueue : public std::runtime_error
+  {
+  public:
+    IncompatibleQueue(const std::string& reason) : runtime_error("The shared memory queue is not compatible: " + reason) {}
+  };
+
+private:
+  static constexpr std::uint64_t magicNumber = 0x3151454d48535300; // "\0SHMEQ1" marks a fully set up queue
+  static constexpr std::uint32_t layoutVersion = 1;                // Increment when the layout changes
+  static constexpr std::size_t   cacheLineSize = 64;
+
+  using Sequence = Detail::SlotSequence<Capacity>; // The slot sequence protocol. See SlotSequence.h
+
+  struct Slot
+  {
+    std::atomic<std::uint64_t> sequence;           // Position this slot is next ready for, see SlotSequence.h
+    alignas(T) unsigned char   storage[sizeof(T)]; // Copy of the object
+  };
+
+  // Everything in the shared memory
+  struct Segment
+  {
+    std::atomic<std::uint64_t> magic; // Set last by the process which creates the queue
+    std::uint32_t              version;
+    std::uint32_t              itemSize;
+    std::uint64_t              capacity;
+
+    alignas(cacheLineSize) std::atomic<std::uint64_t> enqueuePos; // Next position a producer will claim
+    alignas(cacheLineSize) std::atomic<std::uint64_t> dequeuePos; // Next position a consumer will claim
+    alignas(cacheLineSize) Slot slots[Capacity];                  // Underlying ring
+  };
+
+  Segment* mSegment{ nullptr };
+
+  void checkSegment() const;
+};
+
+// Only one process can create the queue, so only one sets it up. Any other process waits until the creator has sized
+// the memory and written the magic number. If the creator fails after creating the name it removes it again, but if it
+// dies part way through the name is left behind, so the wait is limited and remove() clears it.
+template<typename T, std::size_t Capacity>
+SharedMemoryQueue<T, Capacity>::SharedMemoryQueue(const std::string& name, const std::chrono::milliseconds setupTimeout)
+{
+  bool created{ true };
+  int  file = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (file < 0 && errno == EEXIST)
+  {
+    created = false;
+    file = ::shm_open(name.c_str(), O_RDWR, 0600);
+  }
+  if (file < 0)
+  {
+    throw std::system_error(errno, std::generic_category(), "Could not open shared memory " + name);
+  }
+
+  // Close the file and, if this process created the name, remove it so other processes do not wait on a queue which will
+  // never be set up. Returns errno as it was before cleaning up.
+  const auto abandon = [&name, file, created]() {
+    const int error = errno;
+    ::close(file);
+    if (created)
+    {
+      ::shm_unlink(name.c_str());
+    }
+    return error;
+  };
+  const std::chrono::steady_clock::time_point deadline = Detail::deadlineAfter(setupTimeout);
+  const std::string notSetUp = "it was not set up in time. If the process creating it died, call remove()";
+
+  if (created && ::ftruncate(file, sizeof(Segment)) != 0)
+  {
+    const int error = abandon();
+    throw std::system_error(error, std::generic_category(), "Could not size shared memory " + name);
+  }
+
+  if (!created)
+  {
+    struct stat status;
+    for (;;) // Wait for the creator to size it
+    {
+      if (::fstat(file, &status) != 0)
+      {
+        const int error = abandon();
+        throw std::system_error(error, std::generic_category(), "Could not read the size of shared memory " + name);
+      }
+      if (status.st_size != 0)
+      {
+        break;
+      }
+      if (!(std::chrono::steady_clock::now() < deadline))
+      {
+        abandon();
+        throw IncompatibleQueue(notSetUp);
+      }
+      std::this_thread::yield();
+    }
+    if (static_cast<std::size_t>(status.st_size) != sizeof(Segment))
+    {
+      abandon();
+      throw IncompatibleQueue("it is " + std::to_string(status.st_size) + " bytes but " + std::to_string(sizeof(Segment)) + " are needed");
+    }
+  }
+
+  void* mapping = ::mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+  if (mapping == MAP_FAILED)
+  {
+    const int error = abandon();
+    throw std::system_error(error, std::generic_category(), "Could not map shared memory " + name);
+  }
+  ::close(file); // The mapping keeps the memory open
+  mSegment = static_cast<Segment*>(mapping);
+
+  if (created) // The memory is zero filled. Set up the slots as BoundedQueue does, then publish the magic number.
+  {
+    mSegment->version = layoutVersion;
+    mSegment->itemSize = sizeof(T);
+    mSegment->capacity = Capacity;
+    Sequence::initialise(mSegment->slots);
+    mSegment->magic.store(magicNumber, std::memory_order_release);
+  }
+  else
+  {
+    while (mSegment->magic.load(std::memory_order_acquire) == 0) // Wait for the creator to finish setting up
+    {
+      if (!(std::chrono::steady_clock::now() < deadline))
+      {
+        ::munmap(mSegment, sizeof(Segment));
+        throw IncompatibleQueue(notSetUp);
+      }
+      std::this_thread::yield();
+    }
+  }
+  checkSegment();
+}
+
+template<typename T, std::size_t Capacity>
+SharedMemoryQueue<T, Capacity>::~SharedMemoryQueue()
+{
+  ::munmap(mSegment, sizeof(Segment));
+}
+
+template<typename T, std::size_t Capacity>
+void
+SharedMemoryQueue<T, Capacity>::remove(const std::string& name)
+{
+  if (::shm_unlink(name.c_str()) != 0 && errno != ENOENT)
+  {
+    throw std::system_error(errno, std::generic_category(), "Could not remove shared memory " + name);
+  }
+}
+
+template<typename T, std::size_t Capacity>
+void
+SharedMemoryQueue<T, Capacity>::checkSegment() const
+{
+  std::string problem;
+  if (mSegment->magic.load(std::memory_order_relaxed) != magicNumber)
+  {
+    problem = "it is not a queue";
+  }
+  else if (mSegment->version != layoutVersion)
+  {
+    problem = "it is version " + std::to_string(mSegment->version) + " but version " + std::to_string(layoutVersion) + " is needed";
+  }
+  else if (mSegment->itemSize != sizeof(T) || mSegment->capacity != Capacity)
+  {
+    problem = "it holds " + std::to_string(mSegment->capacity) + " items of " + std::to_string(mSegment->itemSize) + " bytes";
+  }
+
+  if (!problem.empty())
+  {
+    ::munmap(mSegment, sizeof(Segment));
+    throw IncompatibleQueue(problem);
+  }
+}
+
+template<typename T, std::size_t Capacity>
+void
+SharedMemoryQueue<T, Capacity>::push(const T& object)
+{
+  while (!tryPush(object)) // The other process may not be running, so give up the time slice rather than spinning
+  {
+    std::this_thread::yield();
+  }
+}
+
+template<typename T, std::size_t Capacity>
+bool
+SharedMemoryQueue<T, Capacity>::tryPush(const T& object)
+{
+  std::uint64_t pos;
+  Slot* const   slot = Sequence::claimPush(mSegment->enqueuePos, mSegment->slots, pos);
+  if (slot == nullptr) // The consumer has not yet released this slot so the ring is full
+  {
+    return false;
+  }
+
+  std::memcpy(slot->storage, &object, sizeof(T));
+  Sequence::publishPush(*slot, pos);
+  return true;
+}
+
+template<typename T, std::size_t Capacity>
+T
+SharedMemoryQueue<T, Capacity>::waitGet()
+{
+  std::optional<T> object;
+  while (!(object = tryGet()))
+  {
+    std::this_thread::yield();
+  }
+  return *object;
+}
+
+template<typename T, std::size_t Capacity>
+template<typename Rep, typename Period>
+std::optional<T>
+SharedMemoryQueue<T, Capacity>::waitGetFor(const std::chrono::duration<Rep, Period>& timeout)
+{
+  const std::chrono::steady_clock::time_point deadline = Detail::deadlineAfter(timeout);
+  std::optional<T>                            object;
+  while (!(object = tryGet()) && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::yield();
+  }
+  return object;
+}
+
+template<typename T, std::size_t Capacity>
+std::optional<T>
+SharedMemoryQueue<T, Capacity>::tryGet()
+{
+  std::uint64_t pos;
+  Slot* const   slot = Sequence::claimPop(mSegment->dequeuePos, mSegment->slots, pos);
+  if (slot == nullptr) // No producer has published this slot yet so the ring is empty
+  {
+    return std::nullopt;
+  }
+
+  // Copy the bytes out before handing the slot back, then make the object from them, so T need not be default constructible
+  alignas(T) unsigned char copy[sizeof(T)];
+  std::memcpy(copy, slot->storage, sizeof(T));
+  Sequence::releasePop(*slot, pos);
+  return *std::launder(reinterpret_cast<const T*>(copy));
+}
+
+template<typename T, std::size_t Capacity>
+bool
+SharedMemoryQueue<T, Capacity>::isEmpty() const
+{
+  return Sequence::isEmpty(mSegment->dequeuePos, mSegment->slots);
+}
+
+} // End namespace Concurrent
+#endif // End header guard
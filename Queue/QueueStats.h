@@ -0,0 +1,81 @@
+#ifndef CONCURRENT_QUEUESTATS_H
+#define CONCURRENT_QUEUESTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Concurrent
+{
+
+// Counters returned by Queue::stats()
+struct QueueStats
+{
+  std::uint64_t            pushes{ 0 };   // Elements pushed
+  std::uint64_t            pops{ 0 };     // Elements retrieved
+  std::uint64_t            waits{ 0 };    // Times a consumer found the queue empty and blocked on the condition variable
+  std::chrono::nanoseconds waitTime{ 0 }; // Total time consumers spent blocked
+  std::size_t              maxDepth{ 0 }; // Most elements held at once
+};
+
+// Stats policies decide whether a Queue keeps QueueStats. The queue calls the hooks with its mutex held.
+
+// Keep no statistics. Every hook is empty, so this costs nothing, and Queue::stats() does not compile.
+struct NoQueueStats
+{
+  static constexpr bool enabled = false;
+
+  void onPush(std::size_t, std::size_t) {}
+  void onPop(std::size_t) {}
+  void onWait(std::chrono::nanoseconds) {}
+};
+
+// Count with relaxed atomics, so a snapshot can also be taken without the queue's mutex.
+// Timing a wait reads the clock twice, but only when a consumer actually blocks.
+class CountQueueStats
+{
+public:
+  static constexpr bool enabled = true;
+
+  void
+  onPush(const std::size_t count, const std::size_t depth)
+  {
+    mPushes.fetch_add(count, std::memory_order_relaxed);
+    if (depth > mMaxDepth.load(std::memory_order_relaxed))
+    {
+      mMaxDepth.store(depth, std::memory_order_relaxed);
+    }
+  }
+
+  void onPop(const std::size_t count) { mPops.fetch_add(count, std::memory_order_relaxed); }
+
+  void
+  onWait(const std::chrono::nanoseconds waited)
+  {
+    mWaits.fetch_add(1, std::memory_order_relaxed);
+    mWaitTime.fetch_add(waited.count(), std::memory_order_relaxed);
+  }
+
+  QueueStats
+  snapshot() const
+  {
+    QueueStats stats;
+    stats.pushes = mPushes.load(std::memory_order_relaxed);
+    stats.pops = mPops.load(std::memory_order_relaxed);
+    stats.waits = mWaits.load(std::memory_order_relaxed);
+    stats.waitTime = std::chrono::nanoseconds(mWaitTime.load(std::memory_order_relaxed));
+    stats.maxDepth = mMaxDepth.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+private:
+  std::atomic<std::uint64_t>                 mPushes{ 0 };
+  std::atomic<std::uint64_t>                 mPops{ 0 };
+  std::atomic<std::uint64_t>                 mWaits{ 0 };
+  std::atomic<std::chrono::nanoseconds::rep> mWaitTime{ 0 };
+  std::atomic<std::size_t>                   mMaxDepth{ 0 }; // Only written with the queue's mutex held
+};
+
+} // End namespace Concurrent
+#endif // End header guard
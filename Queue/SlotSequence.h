@@ -0,0 +1,112 @@
+#ifndef CONCURRENT_SLOTSEQUENCE_H
+#define CONCURRENT_SLOTSEQUENCE_H
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace Concurrent
+{
+namespace Detail
+{
+
+// The slot sequence protocol shared by BoundedQueue and SharedMemoryQueue. Each Slot has an atomic sequence member,
+// which tells producers and consumers whether the slot is ready for them:
+//   A producer may write to a slot when its sequence equals the producer's position. After writing it publishes the
+//   slot to consumers by setting the sequence to position + 1.
+//   A consumer may read from a slot when its sequence equals the consumer's position + 1. After reading it hands the
+//   slot back to producers for the next lap by setting the sequence to position + Capacity.
+// Positions only ever increase, and position p uses slot p % Capacity.
+template<std::size_t Capacity>
+struct SlotSequence
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+
+  static constexpr std::size_t indexMask = Capacity - 1;
+
+  // Make every slot ready for the first lap of producers
+  template<typename Slot>
+  static void
+  initialise(Slot* slots)
+  {
+    for (std::size_t i = 0; i < Capacity; ++i)
+    {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Claim the next slot for a producer, setting pos to its position. Returns nullptr if the ring is full.
+  template<typename Slot, typename Position>
+  static Slot*
+  claimPush(std::atomic<Position>& enqueuePos, Slot* slots, Position& pos)
+  {
+    return claim(enqueuePos, slots, pos, Position{ 0 });
+  }
+
+  template<typename Slot, typename Position>
+  static void
+  publishPush(Slot& slot, const Position pos)
+  {
+    slot.sequence.store(pos + 1, std::memory_order_release);
+  }
+
+  // Claim the next slot for a consumer, setting pos to its position. Returns nullptr if the ring is empty.
+  template<typename Slot, typename Position>
+  static Slot*
+  claimPop(std::atomic<Position>& dequeuePos, Slot* slots, Position& pos)
+  {
+    return claim(dequeuePos, slots, pos, Position{ 1 });
+  }
+
+  template<typename Slot, typename Position>
+  static void
+  releasePop(Slot& slot, const Position pos)
+  {
+    slot.sequence.store(pos + Capacity, std::memory_order_release);
+  }
+
+  template<typename Slot, typename Position>
+  static bool
+  isEmpty(const std::atomic<Position>& dequeuePos, const Slot* slots)
+  {
+    const Position pos = dequeuePos.load(std::memory_order_acquire);
+    const Position seq = slots[pos & indexMask].sequence.load(std::memory_order_acquire);
+    // The slot at the dequeue position is only readable once a producer has published it as pos + 1
+    return static_cast<std::make_signed_t<Position>>(seq - (pos + 1)) < 0;
+  }
+
+private:
+  // A slot is ready when its sequence is pos + offset. A sequence behind that means the other side has not finished
+  // with the slot yet, so the ring is full (for producers) or empty (for consumers).
+  template<typename Slot, typename Position>
+  static Slot*
+  claim(std::atomic<Position>& next, Slot* slots, Position& pos, const Position offset)
+  {
+    pos = next.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      Slot* const    slot = &slots[pos & indexMask];
+      const Position seq = slot->sequence.load(std::memory_order_acquire);
+      const auto     diff = static_cast<std::make_signed_t<Position>>(seq - (pos + offset));
+      if (diff == 0)
+      {
+        if (next.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          return slot;
+        }
+      }
+      else if (diff < 0) // The other side has not finished with this slot
+      {
+        return nullptr;
+      }
+      else // Another thread claimed this position first
+      {
+        pos = next.load(std::memory_order_relaxed);
+      }
+    }
+  }
+};
+
+} // End namespace Detail
+} // End namespace Concurrent
+#endif // End header guard
@@ -0,0 +1,171 @@
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "ConcurrentBoundedQueue.h"
+#include "catch.hpp"
+
+SCENARIO("Basic Usage of a bounded queue")
+{
+  GIVEN("A bounded queue with capacity for 8 strings")
+  {
+    Concurrent::BoundedQueue<std::string, 8> queue;
+
+    THEN("The queue will be empty") { CHECK(queue.isEmpty() == true); }
+
+    WHEN("The queue is filled")
+    {
+      for (int i = 0; i < 8; i++)
+      {
+        CHECK(queue.tryPush(std::to_string(i)) == true);
+      }
+
+      THEN("The queue will not be empty") { CHECK(queue.isEmpty() == false); }
+
+      THEN("Pushing another item will fail") { CHECK(queue.tryPush("Too many") == false); }
+
+      THEN("The items are retrieved in order")
+      {
+        for (int i = 0; i < 8; i++)
+        {
+          auto val = queue.tryGet();
+          CHECK(val.has_value() == true);
+          CHECK(val == std::to_string(i));
+        }
+        CHECK(queue.isEmpty() == true);
+        CHECK(queue.tryGet().has_value() == false);
+      }
+    }
+
+    WHEN("Many more items than the capacity pass through the queue")
+    {
+      for (int i = 0; i < 100; i++)
+      {
+        queue.push(std::to_string(i));
+        CHECK(queue.waitGet() == std::to_string(i));
+      }
+
+      THEN("The queue will be empty") { CHECK(queue.isEmpty() == true); }
+    }
+  }
+}
+
+namespace
+{
+// Copying throws when the id matches throwOn, as a copy which fails to allocate would
+struct Fragile
+{
+  static inline int throwOn{ -1 };
+  int               id;
+
+  explicit Fragile(const int i) : id(i) {}
+  Fragile(const Fragile& other) : id(other.id)
+  {
+    if (id == throwOn)
+    {
+      throw std::runtime_error("Copy failed");
+    }
+  }
+  Fragile(Fragile&&) noexcept = default;
+  Fragile& operator=(const Fragile&) = default;
+  Fragile& operator=(Fragile&&) noexcept = default;
+};
+} // namespace
+
+SCENARIO("A copy which throws while pushing to a bounded queue")
+{
+  GIVEN("A bounded queue with capacity for 2 items")
+  {
+    Concurrent::BoundedQueue<Fragile, 2> queue;
+    Fragile::throwOn = 1;
+
+    WHEN("Pushing copies of items fails part way through")
+    {
+      const Fragile first(0);
+      const Fragile second(1);
+      CHECK(queue.tryPush(first) == true);
+      CHECK_THROWS_AS(queue.push(second), std::runtime_error);
+      CHECK_THROWS_AS(queue.tryPush(second), std::runtime_error);
+
+      THEN("The queue still holds the items which were pushed and has room for more")
+      {
+        CHECK(queue.tryPush(Fragile(2)) == true);
+        CHECK(queue.waitGet().id == 0);
+        CHECK(queue.waitGet().id == 2);
+        CHECK(queue.isEmpty() == true);
+        CHECK(queue.tryGet().has_value() == false);
+      }
+    }
+    Fragile::throwOn = -1;
+  }
+}
+
+SCENARIO("Blocking on a full or empty bounded queue")
+{
+  GIVEN("An empty bounded queue")
+  {
+    Concurrent::BoundedQueue<int, 2> queue;
+
+    WHEN("A thread waits on the empty queue and data is pushed after a short while")
+    {
+      std::future<int> consumer = std::async(std::launch::async, [&queue]() { return queue.waitGet(); });
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      queue.push(42);
+
+      THEN("The waiting thread will get the new item") { CHECK(consumer.get() == 42); }
+    }
+
+    WHEN("A thread pushes to a full queue and an item is consumed after a short while")
+    {
+      queue.push(1);
+      queue.push(2);
+      std::future<void> producer = std::async(std::launch::async, [&queue]() { queue.push(3); });
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      CHECK(queue.waitGet() == 1);
+      producer.get();
+
+      THEN("The blocked item is added to the queue")
+      {
+        CHECK(queue.waitGet() == 2);
+        CHECK(queue.waitGet() == 3);
+      }
+    }
+  }
+}
+
+TEST_CASE("Sum numbers through a bounded queue")
+{
+  constexpr int                     itemsPerProducer = 100000;
+  Concurrent::BoundedQueue<int, 64> queue;
+
+  auto produce = [&queue](int offset) {
+    long long total{ 0 };
+    for (int i = 0; i < itemsPerProducer; ++i)
+    {
+      queue.push(offset + i);
+      total += offset + i;
+    }
+    return total;
+  };
+  auto consume = [&queue](int count) {
+    long long total{ 0 };
+    for (int i = 0; i < count; ++i)
+    {
+      total += queue.waitGet();
+    }
+    return total;
+  };
+
+  std::future<long long> consumer1Total = std::async(std::launch::async, consume, itemsPerProducer * 3 / 2);
+  std::future<long long> consumer2Total = std::async(std::launch::async, consume, itemsPerProducer * 3 / 2);
+  std::future<long long> producer1Total = std::async(std::launch::async, produce, 0);
+  std::future<long long> producer2Total = std::async(std::launch::async, produce, itemsPerProducer);
+  std::future<long long> producer3Total = std::async(std::launch::async, produce, itemsPerProducer * 2);
+
+  long long prodTotal = producer1Total.get() + producer2Total.get() + producer3Total.get();
+  long long consTotal = consumer1Total.get() + consumer2Total.get();
+
+  CHECK(prodTotal == consTotal);
+  CHECK(queue.isEmpty() == true);
+}
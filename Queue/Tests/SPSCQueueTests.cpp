@@ -0,0 +1,80 @@
+#include <future>
+#include <memory>
+#include <string>
+
+#include "ConcurrentSPSCQueue.h"
+#include "catch.hpp"
+
+SCENARIO("Basic Usage of a single producer single consumer queue")
+{
+  GIVEN("A queue with capacity for 4 strings")
+  {
+    Concurrent::SPSCQueue<std::string, 4> queue;
+
+    THEN("The queue will be empty")
+    {
+      CHECK(queue.isEmpty() == true);
+      CHECK(queue.tryGet().has_value() == false);
+    }
+
+    WHEN("The queue is filled")
+    {
+      for (int i = 0; i < 4; i++)
+      {
+        CHECK(queue.tryPush(std::to_string(i)) == true);
+      }
+
+      THEN("Pushing another item will fail") { CHECK(queue.tryPush("Too many") == false); }
+
+      THEN("The items are retrieved in order")
+      {
+        for (int i = 0; i < 4; i++)
+        {
+          CHECK(queue.tryGet() == std::to_string(i));
+        }
+        CHECK(queue.isEmpty() == true);
+      }
+    }
+  }
+}
+
+SCENARIO("Objects left in a single producer single consumer queue are destroyed")
+{
+  auto tracker = std::make_shared<int>(0);
+  {
+    Concurrent::SPSCQueue<std::shared_ptr<int>, 8> queue;
+    queue.push(tracker);
+    queue.push(tracker);
+    CHECK(tracker.use_count() == 3);
+  }
+  CHECK(tracker.use_count() == 1);
+}
+
+TEST_CASE("Hand numbers from one thread to another")
+{
+  constexpr int                    count = 1000000;
+  Concurrent::SPSCQueue<int, 1024> queue;
+
+  std::future<long long> producerTotal = std::async(std::launch::async, [&queue]() {
+    long long total{ 0 };
+    for (int i = 0; i < count; ++i)
+    {
+      queue.push(i);
+      total += i;
+    }
+    return total;
+  });
+
+  // Items must arrive in the order they were pushed
+  long long consTotal{ 0 };
+  bool      inOrder{ true };
+  for (int i = 0; i < count; ++i)
+  {
+    int val = queue.waitGet();
+    inOrder = inOrder && (val == i);
+    consTotal += val;
+  }
+
+  CHECK(inOrder == true);
+  CHECK(producerTotal.get() == consTotal);
+}
@@ -1,6 +1,12 @@
+#include <array>
 #include <chrono>
+#include <deque>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "ConcurrentQueue.h"
 #include "catch.hpp"
@@ -80,6 +86,346 @@ SCENARIO("Basic Usage waitGet()")
   }
 }
 
+SCENARIO("Timed waits")
+{
+  GIVEN("An empty queue")
+  {
+    Concurrent::Queue<std::string> queue;
+
+    WHEN("A thread waits for a short duration")
+    {
+      auto start = std::chrono::steady_clock::now();
+      auto val = queue.waitGetFor(std::chrono::milliseconds(100));
+
+      THEN("Nothing is returned once the timeout has expired")
+      {
+        CHECK(val.has_value() == false);
+        CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(100));
+      }
+    }
+
+    WHEN("A thread waits until a deadline which has already passed")
+    {
+      auto val = queue.waitGetUntil(std::chrono::system_clock::now() - std::chrono::seconds(1));
+      THEN("Nothing is returned") { CHECK(val.has_value() == false); }
+    }
+
+    WHEN("Data is inserted into the queue while a thread is waiting")
+    {
+      std::optional<std::string> data;
+      std::thread                thread1([&queue, &data]() { data = queue.waitGetFor(std::chrono::seconds(10)); });
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      queue.push("A new item");
+
+      THEN("The waiting thread will get the new item")
+      {
+        thread1.join();
+        CHECK(data == "A new item");
+      }
+    }
+
+    WHEN("A thread waits with a timeout too long to add to the current time")
+    {
+      std::optional<std::string> data;
+      std::thread                thread1([&queue, &data]() { data = queue.waitGetFor(std::chrono::hours::max()); });
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      queue.push("A new item");
+
+      THEN("The thread waits for the data rather than timing out")
+      {
+        thread1.join();
+        CHECK(data == "A new item");
+      }
+    }
+
+    WHEN("The queue has data")
+    {
+      queue.push("Waiting");
+      THEN("A timed wait returns the data immediately") { CHECK(queue.waitGetUntil(std::chrono::steady_clock::now()) == "Waiting"); }
+    }
+  }
+}
+
+SCENARIO("Closing a queue")
+{
+  GIVEN("A queue of 2 strings which is then closed")
+  {
+    Concurrent::Queue<std::string> queue;
+    queue.push("0");
+    queue.push("1");
+    queue.close();
+
+    THEN("The queue reports it is closed") { CHECK(queue.isClosed() == true); }
+
+    THEN("Pushing to the queue fails")
+    {
+      CHECK(queue.push("2") == false);
+      std::vector<std::string> more{ "3", "4" };
+      CHECK(queue.push(std::move(more)) == false);
+      CHECK(more.size() == 2);
+    }
+
+    THEN("The remaining data can still be retrieved")
+    {
+      CHECK(queue.waitGet() == "0");
+      CHECK(queue.waitGetFor(std::chrono::seconds(10)) == "1");
+
+      WHEN("The queue has been drained")
+      {
+        THEN("Waiting returns immediately without data")
+        {
+          std::vector<std::string> out;
+          CHECK(queue.waitGetBulk(std::back_inserter(out), 10) == 0);
+          CHECK(queue.waitGetFor(std::chrono::seconds(10)).has_value() == false);
+          CHECK_THROWS_AS(queue.waitGet(), Concurrent::Queue<std::string>::Closed);
+        }
+      }
+    }
+  }
+
+  GIVEN("An empty queue with waiting consumers")
+  {
+    Concurrent::Queue<int> queue;
+    std::size_t            count1{ 1 };
+    std::size_t            count2{ 1 };
+    std::vector<int>       out1;
+    std::vector<int>       out2;
+    std::thread            thread1([&]() { count1 = queue.waitGetBulk(std::back_inserter(out1), 10); });
+    std::thread            thread2([&]() { count2 = queue.waitGetBulk(std::back_inserter(out2), 10); });
+
+    WHEN("The queue is closed")
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      queue.close();
+
+      THEN("All the consumers are woken")
+      {
+        thread1.join();
+        thread2.join();
+        CHECK(count1 == 0);
+        CHECK(count2 == 0);
+      }
+    }
+  }
+}
+
+SCENARIO("Spin then block wait policy")
+{
+  GIVEN("An empty queue which spins before blocking")
+  {
+    Concurrent::Queue<std::string, std::deque<std::string>, Concurrent::SpinThenBlockWait<100, 2>> queue;
+
+    WHEN("A thread pops the empty queue")
+    {
+      std::string data;
+      std::thread thread1([&queue, &data]() { data = queue.waitGet(); });
+
+      WHEN("Data is inserted into the queue after the spinning has finished")
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        queue.push("A new item");
+
+        THEN("The blocked thread will get the new item")
+        {
+          thread1.join();
+          CHECK(data == "A new item");
+        }
+      }
+    }
+
+    WHEN("Data is already in the queue")
+    {
+      queue.push("An item");
+      THEN("The data is returned straight away") { CHECK(queue.waitGetFor(std::chrono::seconds(0)) == "An item"); }
+    }
+  }
+}
+
+SCENARIO("Spinning stops at a deadline or when the queue is closed")
+{
+  // Enough spins to take several seconds if they all ran
+  using LongSpinQueue = Concurrent::Queue<int, std::deque<int>, Concurrent::SpinThenBlockWait<100000000, 0>>;
+
+  GIVEN("An empty queue which spins for a long time before blocking")
+  {
+    LongSpinQueue queue;
+    const auto    start = std::chrono::steady_clock::now();
+
+    WHEN("A thread waits with a timeout of zero")
+    {
+      auto val = queue.waitGetFor(std::chrono::milliseconds(0));
+      THEN("It returns straight away")
+      {
+        CHECK(val.has_value() == false);
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+      }
+    }
+
+    WHEN("A thread waits until a deadline which has already passed")
+    {
+      auto val = queue.waitGetUntil(std::chrono::steady_clock::now() - std::chrono::seconds(1));
+      THEN("It returns straight away")
+      {
+        CHECK(val.has_value() == false);
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+      }
+    }
+
+    WHEN("The queue is closed")
+    {
+      queue.close();
+      THEN("A waiting thread sees the close straight away")
+      {
+        CHECK_THROWS_AS(queue.waitGet(), LongSpinQueue::Closed);
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+      }
+    }
+  }
+}
+
+SCENARIO("A burst of pushes wakes every waiting consumer")
+{
+  GIVEN("An empty queue with 3 waiting consumers")
+  {
+    Concurrent::Queue<int>            queue;
+    std::array<std::optional<int>, 3> data;
+    std::vector<std::thread>          threads;
+    for (auto& item : data)
+    {
+      threads.emplace_back([&queue, &item]() { item = queue.waitGetFor(std::chrono::seconds(10)); });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    WHEN("3 items are pushed one after another")
+    {
+      queue.push(1);
+      queue.push(2);
+      queue.push(3);
+
+      THEN("Every consumer gets an item without waiting for its timeout")
+      {
+        auto start = std::chrono::steady_clock::now();
+        for (auto& thread : threads)
+        {
+          thread.join();
+        }
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+        CHECK(data[0].has_value() == true);
+        CHECK(data[1].has_value() == true);
+        CHECK(data[2].has_value() == true);
+      }
+    }
+  }
+}
+
+SCENARIO("Batch insertion and bulk retrieval")
+{
+  GIVEN("An empty queue")
+  {
+    Concurrent::Queue<std::string> queue;
+
+    WHEN("A range of 5 strings and a vector of 5 strings are pushed")
+    {
+      std::vector<std::string> range{ "0", "1", "2", "3", "4" };
+      queue.pushRange(range.begin(), range.end());
+      queue.push(std::vector<std::string>{ "5", "6", "7", "8", "9" });
+
+      THEN("Bulk retrieval returns at most the requested number of items in order")
+      {
+        std::vector<std::string> out;
+        CHECK(queue.tryGetBulk(std::back_inserter(out), 3) == 3);
+        CHECK(queue.waitGetBulk(std::back_inserter(out), 3) == 3);
+        CHECK(out.size() == 6);
+
+        WHEN("More items are requested than are in the queue")
+        {
+          CHECK(queue.tryGetBulk(std::back_inserter(out), 100) == 4);
+
+          THEN("All the items have been retrieved in order")
+          {
+            for (int i = 0; i < 10; i++)
+            {
+              CHECK(out[i] == std::to_string(i));
+            }
+            CHECK(queue.isEmpty() == true);
+            CHECK(queue.tryGetBulk(std::back_inserter(out), 100) == 0);
+          }
+        }
+      }
+    }
+
+    WHEN("A thread waits for a bulk retrieval on the empty queue")
+    {
+      std::vector<int>       data;
+      Concurrent::Queue<int> intQueue;
+      std::thread            thread1([&intQueue, &data]() { intQueue.waitGetBulk(std::back_inserter(data), 10); });
+      std::vector<int>       nums{ 1, 2, 3 };
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      intQueue.pushRange(nums.begin(), nums.end());
+
+      THEN("The waiting thread will get the new items")
+      {
+        thread1.join();
+        CHECK(data == nums);
+      }
+    }
+  }
+}
+
+// Copying throws when the id matches throwOn
+struct Brittle
+{
+  Brittle(int i) : id(i) {}
+  Brittle(const Brittle& other) : id(other.id)
+  {
+    if (id == throwOn)
+    {
+      throw std::runtime_error("Copy failed");
+    }
+  }
+  Brittle(Brittle&&) noexcept = default;
+  Brittle& operator=(Brittle&&) noexcept = default;
+
+  int               id;
+  inline static int throwOn{ -1 };
+};
+
+SCENARIO("A batch which fails part way through")
+{
+  GIVEN("A queue which counts its pushes and a thread waiting on it")
+  {
+    using CountingQueue = Concurrent::Queue<Brittle, std::deque<Brittle>, Concurrent::BlockingWait, Concurrent::CountQueueStats>;
+    CountingQueue          queue;
+    std::optional<Brittle> received;
+    std::thread            consumer([&queue, &received]() { received = queue.waitGetFor(std::chrono::seconds(5)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    WHEN("Copying the third item of a batch throws")
+    {
+      const std::vector<Brittle> batch{ 0, 1, 2, 3 };
+      const auto                 start = std::chrono::steady_clock::now();
+      Brittle::throwOn = 2;
+      CHECK_THROWS_AS(queue.pushRange(batch.begin(), batch.end()), std::runtime_error);
+      Brittle::throwOn = -1;
+      consumer.join();
+
+      THEN("The waiting thread is woken for the items which were pushed")
+      {
+        CHECK((received.has_value() && received->id == 0));
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+      }
+
+      THEN("The items which were pushed are counted and can be retrieved")
+      {
+        CHECK(queue.stats().pushes == 2);
+        const std::optional<Brittle> second = queue.tryGet();
+        CHECK((second.has_value() && second->id == 1));
+        CHECK(queue.isEmpty() == true);
+      }
+    }
+  }
+}
+
 SCENARIO("Copy construct & copy assign a queue")
 {
   GIVEN("A queue of 20 strings")
@@ -192,4 +538,113 @@ SCENARIO("Object without default constructor")
   Concurrent::Queue<NotDefaultConstructable> queue;
   queue.push(NotDefaultConstructable{ 5 });
   CHECK(queue.waitGet().val == 5);
-}
\ No newline at end of file
+}
+
+SCENARIO("Construct an object in place")
+{
+  GIVEN("An empty queue of Counter objects")
+  {
+    Concurrent::Queue<Counter> queue;
+    const size_t               ctorCount = Counter::ctorCount;
+    const size_t               copyCtorCount = Counter::copyCtorCount;
+    const size_t               moveCtorCount = Counter::moveCtorCount;
+
+    WHEN("An object is emplaced into the queue")
+    {
+      queue.emplace();
+
+      THEN("Only the constructor will be called")
+      {
+        CHECK(Counter::ctorCount == ctorCount + 1);
+        CHECK(Counter::copyCtorCount == copyCtorCount); // No change
+        CHECK(Counter::moveCtorCount == moveCtorCount); // No change
+      }
+    }
+  }
+
+  GIVEN("An empty queue of pairs")
+  {
+    Concurrent::Queue<std::pair<int, std::string>> queue;
+
+    WHEN("A pair is emplaced from its constructor arguments")
+    {
+      queue.emplace(1, "one");
+      THEN("The constructed pair can be retrieved") { CHECK(queue.waitGet() == std::make_pair(1, std::string{ "one" })); }
+    }
+  }
+}
+
+SCENARIO("Queue statistics")
+{
+  using CountedQueue = Concurrent::Queue<int, std::deque<int>, Concurrent::BlockingWait, Concurrent::CountQueueStats>;
+
+  THEN("The default policy adds nothing to the size of the queue")
+  {
+    CHECK(sizeof(Concurrent::Queue<int>) == sizeof(Concurrent::Queue<int, std::deque<int>, Concurrent::BlockingWait, Concurrent::NoQueueStats>));
+    CHECK(sizeof(Concurrent::Queue<int>) < sizeof(CountedQueue));
+  }
+
+  GIVEN("An empty queue which counts its activity")
+  {
+    CountedQueue queue;
+
+    THEN("Every counter starts at zero")
+    {
+      const Concurrent::QueueStats stats = queue.stats();
+      CHECK(stats.pushes == 0);
+      CHECK(stats.pops == 0);
+      CHECK(stats.waits == 0);
+      CHECK(stats.waitTime == std::chrono::nanoseconds(0));
+      CHECK(stats.maxDepth == 0);
+    }
+
+    WHEN("Items are pushed one at a time and as a batch, then retrieved")
+    {
+      queue.push(1);
+      queue.emplace(2);
+      std::vector<int> batch{ 3, 4, 5 };
+      queue.pushRange(batch.begin(), batch.end());
+      queue.tryGet();
+      queue.waitGet();
+      std::vector<int> out;
+      queue.tryGetBulk(std::back_inserter(out), 2);
+      queue.push(6);
+
+      THEN("Every item is counted and the depth is the most held at once")
+      {
+        const Concurrent::QueueStats stats = queue.stats();
+        CHECK(stats.pushes == 6);
+        CHECK(stats.pops == 4);
+        CHECK(stats.maxDepth == 5);
+      }
+
+      THEN("No consumer had to wait as data was always available") { CHECK(queue.stats().waits == 0); }
+    }
+
+    WHEN("A consumer waits for data")
+    {
+      std::thread consumer([&queue]() { queue.waitGet(); });
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      queue.push(1);
+      consumer.join();
+
+      THEN("The wait and how long it lasted are counted")
+      {
+        const Concurrent::QueueStats stats = queue.stats();
+        CHECK(stats.waits == 1);
+        CHECK(stats.waitTime >= std::chrono::milliseconds(50));
+        CHECK(stats.pops == 1);
+      }
+    }
+
+    WHEN("A timed wait expires")
+    {
+      queue.waitGetFor(std::chrono::milliseconds(10));
+      THEN("The wait is counted with nothing retrieved")
+      {
+        CHECK(queue.stats().waits == 1);
+        CHECK(queue.stats().pops == 0);
+      }
+    }
+  }
+}
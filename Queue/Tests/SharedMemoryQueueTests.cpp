@@ -0,0 +1,212 @@
+#include <chrono>
+#include <optional>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ConcurrentSharedMemoryQueue.h"
+#include "catch.hpp"
+
+namespace
+{
+// Unique shared memory name for each test run, removed again at the end of the test
+struct SharedName
+{
+  std::string name{ "/ConcurrentQueueTest." + std::to_string(::getpid()) };
+  ~SharedName() { Concurrent::SharedMemoryQueue<int, 4>::remove(name); }
+};
+
+struct Tick
+{
+  int    id;
+  double price;
+};
+
+// Trivially copyable but not default constructible
+struct Quote
+{
+  explicit Quote(const int p) : price(p) {}
+  int price;
+};
+} // namespace
+
+SCENARIO("Basic Usage of a shared memory queue")
+{
+  GIVEN("A shared memory queue with capacity for 4 ticks")
+  {
+    SharedName                             shared;
+    Concurrent::SharedMemoryQueue<Tick, 4> queue(shared.name);
+
+    THEN("The queue will be empty")
+    {
+      CHECK(queue.isEmpty() == true);
+      CHECK(queue.tryGet().has_value() == false);
+    }
+
+    WHEN("The queue is filled")
+    {
+      for (int i = 0; i < 4; i++)
+      {
+        CHECK(queue.tryPush(Tick{ i, i * 1.5 }) == true);
+      }
+
+      THEN("Pushing another item will fail") { CHECK(queue.tryPush(Tick{ 4, 6.0 }) == false); }
+
+      THEN("Another handle to the same name sees the items in order")
+      {
+        Concurrent::SharedMemoryQueue<Tick, 4> other(shared.name);
+        for (int i = 0; i < 4; i++)
+        {
+          const Tick tick = other.waitGet();
+          CHECK(tick.id == i);
+          CHECK(tick.price == i * 1.5);
+        }
+        CHECK(queue.isEmpty() == true);
+      }
+    }
+
+    WHEN("A thread waits with a timeout for an item which never arrives")
+    {
+      const auto start = std::chrono::steady_clock::now();
+      const auto tick = queue.waitGetFor(std::chrono::milliseconds(50));
+      const auto waited = std::chrono::steady_clock::now() - start;
+
+      THEN("It gives up after the timeout")
+      {
+        CHECK(tick.has_value() == false);
+        CHECK(waited >= std::chrono::milliseconds(50));
+      }
+    }
+
+    WHEN("A thread waits with a timeout and an item is waiting")
+    {
+      queue.push(Tick{ 7, 1.0 });
+      const auto tick = queue.waitGetFor(std::chrono::milliseconds(50));
+
+      THEN("It gets the item") { CHECK((tick.has_value() && tick->id == 7)); }
+    }
+
+    WHEN("The queue is opened with a different capacity")
+    {
+      using Mismatched = Concurrent::SharedMemoryQueue<Tick, 8>;
+      THEN("It is rejected") { CHECK_THROWS_AS(Mismatched(shared.name), Mismatched::IncompatibleQueue); }
+    }
+
+    WHEN("The queue is opened with a different item type")
+    {
+      using Mismatched = Concurrent::SharedMemoryQueue<char, 4>;
+      THEN("It is rejected") { CHECK_THROWS_AS(Mismatched(shared.name), Mismatched::IncompatibleQueue); }
+    }
+  }
+}
+
+SCENARIO("A shared memory queue of items which cannot be default constructed")
+{
+  GIVEN("A shared memory queue of quotes")
+  {
+    SharedName                              shared;
+    Concurrent::SharedMemoryQueue<Quote, 4> queue(shared.name);
+
+    WHEN("A quote is pushed")
+    {
+      queue.push(Quote(42));
+
+      THEN("It can be retrieved")
+      {
+        const std::optional<Quote> quote = queue.tryGet();
+        CHECK((quote.has_value() && quote->price == 42));
+      }
+    }
+  }
+}
+
+SCENARIO("Opening a shared memory queue whose creator never finished")
+{
+  using Queue = Concurrent::SharedMemoryQueue<int, 4>;
+  SharedName shared;
+  Queue::remove(shared.name);
+  const int file = ::shm_open(shared.name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  REQUIRE(file >= 0);
+
+  GIVEN("A creator which stopped before sizing the memory")
+  {
+    THEN("Opening it gives up after the setup timeout") { CHECK_THROWS_AS(Queue(shared.name, std::chrono::milliseconds(50)), Queue::IncompatibleQueue); }
+  }
+
+  GIVEN("A creator which stopped before writing the magic number")
+  {
+    // The size of the segment is not visible from here, so take it from a queue set up under another name
+    SharedName other;
+    other.name += ".sized";
+    struct stat status;
+    {
+      Queue sized(other.name);
+      const int sizedFile = ::shm_open(other.name.c_str(), O_RDONLY, 0600);
+      REQUIRE(sizedFile >= 0);
+      REQUIRE(::fstat(sizedFile, &status) == 0);
+      ::close(sizedFile);
+    }
+    REQUIRE(::ftruncate(file, status.st_size) == 0);
+
+    THEN("Opening it gives up after the setup timeout") { CHECK_THROWS_AS(Queue(shared.name, std::chrono::milliseconds(50)), Queue::IncompatibleQueue); }
+  }
+
+  ::close(file);
+
+  WHEN("The name is removed")
+  {
+    Queue::remove(shared.name);
+
+    THEN("The queue can be created again") { CHECK_NOTHROW(Queue(shared.name)); }
+  }
+}
+
+TEST_CASE("Hand numbers from one process to another")
+{
+  constexpr int count = 100000;
+  SharedName    shared;
+
+  Concurrent::SharedMemoryQueue<int, 256>::remove(shared.name);
+  const pid_t child = ::fork();
+  REQUIRE(child >= 0);
+  if (child == 0) // Producer
+  {
+    // Never let an exception unwind into Catch here, or the child would go on to run the rest of the tests
+    try
+    {
+      Concurrent::SharedMemoryQueue<int, 256> queue(shared.name);
+      for (int i = 0; i < count; ++i)
+      {
+        queue.push(i);
+      }
+    }
+    catch (...)
+    {
+      ::_exit(1);
+    }
+    ::_exit(0); // Skip Catch's and this test's clean up in the child
+  }
+
+  Concurrent::SharedMemoryQueue<int, 256> queue(shared.name);
+  long long                               total{ 0 };
+  for (int i = 0; i < count; ++i)
+  {
+    const std::optional<int> number = queue.waitGetFor(std::chrono::seconds(10)); // Do not wait forever if the child failed
+    if (!number)
+    {
+      break;
+    }
+    total += *number;
+  }
+
+  int status{ -1 };
+  ::waitpid(child, &status, 0);
+  REQUIRE(WIFEXITED(status));
+  CHECK(WEXITSTATUS(status) == 0);
+  CHECK(total == static_cast<long long>(count) * (count - 1) / 2);
+  CHECK(queue.isEmpty() == true);
+}
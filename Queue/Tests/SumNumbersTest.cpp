@@ -1,4 +1,6 @@
 #include <future>
+#include <iterator>
+#include <numeric>
 #include <random>
 #include <vector>
 
@@ -28,16 +30,16 @@ pushData(Concurrent::Queue<int>& queue, std::random_device::result_type seed)
 }
 
 int
-consumeData(Concurrent::Queue<int>& queue, std::atomic<bool>& producersComplete)
+consumeData(Concurrent::Queue<int>& queue)
 {
-  int total{ 0 };
+  int              total{ 0 };
+  std::vector<int> batch;
 
-  while (!producersComplete) // While producers are still pushing data.
+  // Sleeps while the queue is empty. Only returns 0 once the queue has been closed and all the data has been read.
+  while (queue.waitGetBulk(std::back_inserter(batch), 1024) != 0)
   {
-    while (auto data = queue.tryGet()) // While there is still data in the queue.
-    {
-      total += *data;
-    }
+    total = std::accumulate(batch.begin(), batch.end(), total);
+    batch.clear();
   }
   return total;
 }
@@ -50,26 +52,26 @@ consumeData(Concurrent::Queue<int>& queue, std::atomic<bool>& producersComplete)
 // In parallel the consumers
 // - read data from the queue
 // - maintain a total for all the numbers they have read.
-// The consumers stop reading when there is no more data in the queue and the producers have stopped pushing data.
+// Once all the producers have finished the queue is closed.
+// The consumers stop reading when the queue is closed and there is no more data in it.
 // A check is performed to ensure the total of the numbers the producers put in the queue is the same as the total of the numbers
 // the consumers read from the queue.
 // Catch2's INFO macro is not thread safe so the seed has to be generated & printed in main thread rather than in producers thread.
 TEST_CASE("Sum numbers")
 {
   Concurrent::Queue<int>          queue;
-  std::atomic<bool>               producersComplete{ false };
   std::random_device              rd;
   std::random_device::result_type seed = rd();
   INFO("Using seed: " << seed);
 
-  std::future<int> consumer1Total = std::async(consumeData, std::ref(queue), std::ref(producersComplete));
+  std::future<int> consumer1Total = std::async(consumeData, std::ref(queue));
   std::future<int> producer1Total = std::async(pushData, std::ref(queue), seed++);
   std::future<int> producer2Total = std::async(pushData, std::ref(queue), seed++);
-  std::future<int> consumer2Total = std::async(consumeData, std::ref(queue), std::ref(producersComplete));
+  std::future<int> consumer2Total = std::async(consumeData, std::ref(queue));
   std::future<int> producer3Total = std::async(pushData, std::ref(queue), seed++);
 
   int prodTotal = producer1Total.get() + producer2Total.get() + producer3Total.get();
-  producersComplete = true;
+  queue.close();
   int consTotal = consumer1Total.get() + consumer2Total.get();
 
   CHECK(prodTotal == consTotal);
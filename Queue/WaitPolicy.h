@@ -0,0 +1,97 @@
+#ifndef CONCURRENT_WAITPOLICY_H
+#define CONCURRENT_WAITPOLICY_H
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace Concurrent
+{
+
+// Hint to the CPU that this is a busy wait loop.
+// On x86 this stops the pipeline filling with speculative loads and lets a hyper-thread sibling run.
+inline void
+cpuRelax()
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield");
+#endif
+}
+
+// Wait policies decide what a consumer does before it blocks on the condition variable.
+// spin() is called without any lock held and returns true once ready() is true, or false if the caller should block.
+
+// Block on the condition variable straight away.
+struct BlockingWait
+{
+  template<typename Predicate>
+  static bool
+  spin(Predicate&&)
+  {
+    return false;
+  }
+};
+
+// Busy wait for SpinCount checks, then give up the time slice YieldCount times, then block.
+// Avoids the system call and context switch when data arrives within a short gap, at the cost of burning CPU while waiting.
+template<std::size_t SpinCount = 1000, std::size_t YieldCount = 10>
+struct SpinThenBlockWait
+{
+  template<typename Predicate>
+  static bool
+  spin(Predicate&& ready)
+  {
+    for (std::size_t i = 0; i < SpinCount; ++i)
+    {
+      if (ready())
+      {
+        return true;
+      }
+      cpuRelax();
+    }
+    for (std::size_t i = 0; i < YieldCount; ++i)
+    {
+      if (ready())
+      {
+        return true;
+      }
+      std::this_thread::yield();
+    }
+    return ready();
+  }
+};
+
+namespace Detail
+{
+
+// Deadline timeout from now for timed waits. Timeouts too long to add to now, such as std::chrono::hours::max(), give the
+// latest representable time instead of overflowing, and timeouts of zero or less give now.
+template<typename Rep, typename Period>
+std::chrono::steady_clock::time_point
+deadlineAfter(const std::chrono::duration<Rep, Period>& timeout)
+{
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point now = Clock::now();
+  if (timeout <= timeout.zero())
+  {
+    return now;
+  }
+  // Compare as floating point seconds, since converting a long timeout to the clock's ticks is what overflows
+  const Clock::duration room = Clock::time_point::max() - now;
+  if (std::chrono::duration<double>(timeout) >= std::chrono::duration<double>(room))
+  {
+    return Clock::time_point::max();
+  }
+  return now + std::chrono::duration_cast<Clock::duration>(timeout);
+}
+
+} // End namespace Detail
+
+} // End namespace Concurrent
+#endif // End header guard
@@ -0,0 +1,65 @@
+#ifndef CONCURRENT_BUFFERSTATS_H
+#define CONCURRENT_BUFFERSTATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Concurrent
+{
+
+// Counters returned by SearchRingBuffer::stats()
+struct BufferStats
+{
+  std::uint64_t pushes{ 0 };     // Items pushed, including items of a batch which did not fit
+  std::uint64_t reads{ 0 };      // Lookups. Each call of a read function counts once, except readMany() which counts each time.
+  std::uint64_t rejections{ 0 }; // Pushes refused as ItemTooOld. A rejected batch counts once.
+  std::uint64_t overwrites{ 0 }; // Items dropped to make room, so pushes - overwrites is the number of items held
+};
+
+// Stats policies decide whether a SearchRingBuffer keeps BufferStats. Pushes are counted under the writer lock and
+// reads under the reader lock.
+
+// Keep no statistics. Every hook is empty, so this costs nothing, and SearchRingBuffer::stats() does not compile.
+struct NoBufferStats
+{
+  static constexpr bool enabled = false;
+
+  void onPush(std::size_t) {}
+  void onRead(std::size_t) const {}
+  void onReject() {}
+  void onOverwrite(std::size_t) {}
+};
+
+// Count with relaxed atomics. The read counter is shared by every reader thread, so heavily read buffers will see
+// some contention on its cache line.
+class CountBufferStats
+{
+public:
+  static constexpr bool enabled = true;
+
+  void onPush(const std::size_t count) { mPushes.fetch_add(count, std::memory_order_relaxed); }
+  void onRead(const std::size_t count) const { mReads.fetch_add(count, std::memory_order_relaxed); }
+  void onReject() { mRejections.fetch_add(1, std::memory_order_relaxed); }
+  void onOverwrite(const std::size_t count) { mOverwrites.fetch_add(count, std::memory_order_relaxed); }
+
+  BufferStats
+  snapshot() const
+  {
+    BufferStats stats;
+    stats.pushes = mPushes.load(std::memory_order_relaxed);
+    stats.reads = mReads.load(std::memory_order_relaxed);
+    stats.rejections = mRejections.load(std::memory_order_relaxed);
+    stats.overwrites = mOverwrites.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+private:
+  std::atomic<std::uint64_t>         mPushes{ 0 };
+  mutable std::atomic<std::uint64_t> mReads{ 0 }; // Reads are const
+  std::atomic<std::uint64_t>         mRejections{ 0 };
+  std::atomic<std::uint64_t>         mOverwrites{ 0 };
+};
+
+} // End namespace Concurrent
+#endif // End header guard
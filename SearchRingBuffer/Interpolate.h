@@ -0,0 +1,39 @@
+#ifndef CONCURRENT_INTERPOLATE_H
+#define CONCURRENT_INTERPOLATE_H
+
+#include <cmath>
+#include <type_traits>
+
+namespace Concurrent
+{
+
+// Blends two items for SearchRingBuffer::readInterpolated(). fraction is in [0, 1], where 0 gives below and 1 gives above.
+// Arithmetic types are supported. Specialise Interpolate for other types, for example:
+//   template<>
+//   struct Concurrent::Interpolate<Vector3>
+//   {
+//     static Vector3 lerp(const Vector3& below, const Vector3& above, double fraction) { return below + (above - below) * fraction; }
+//   };
+template<typename T, typename Enable = void>
+struct Interpolate;
+
+template<typename T>
+struct Interpolate<T, std::enable_if_t<std::is_arithmetic_v<T>>>
+{
+  static T
+  lerp(const T& below, const T& above, const double fraction)
+  {
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      return below + (above - below) * static_cast<T>(fraction);
+    }
+    else // Blend as double so unsigned types cannot wrap, then round to the nearest value
+    {
+      const double blended = static_cast<double>(below) + (static_cast<double>(above) - static_cast<double>(below)) * fraction;
+      return static_cast<T>(std::round(blended));
+    }
+  }
+};
+
+} // End namespace Concurrent
+#endif // End header guard
@@ -0,0 +1,34 @@
+#ifndef CONCURRENT_KEYTRAITS_H
+#define CONCURRENT_KEYTRAITS_H
+
+#include <chrono>
+#include <type_traits>
+#include <utility>
+
+namespace Concurrent
+{
+namespace Detail
+{
+
+// Type of the difference between two keys, e.g. a duration for std::chrono time points or an integer for integer keys
+template<typename Key>
+using KeyDifference = decltype(std::declval<const Key&>() - std::declval<const Key&>());
+
+// A difference between two keys as a double, for estimating where a key lies between two others
+template<typename Rep, typename Period>
+double
+toDouble(const std::chrono::duration<Rep, Period>& difference)
+{
+  return static_cast<double>(difference.count());
+}
+
+template<typename Arithmetic, std::enable_if_t<std::is_arithmetic_v<Arithmetic>, int> = 0>
+double
+toDouble(const Arithmetic difference)
+{
+  return static_cast<double>(difference);
+}
+
+} // End namespace Detail
+} // End namespace Concurrent
+#endif // End header guard
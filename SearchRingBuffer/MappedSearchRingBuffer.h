@@ -0,0 +1,384 @@
+#ifndef CONCURRENT_MAPPEDSEARCHRINGBUFFER_H
+#define CONCURRENT_MAPPEDSEARCHRINGBUFFER_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SeqLockRing.h"
+
+namespace Concurrent
+{
+
+// Variant of SeqLockSearchRingBuffer whose storage is a memory mapped file (POSIX only), so the history survives a restart.
+// One process opens the file for pushing, which creates it if needed or carries on from where the last writer stopped.
+// Any number of other processes can open it read only and search it. Readers use the same sequence counter protocol as
+// SeqLockSearchRingBuffer, so they never block the writer or each other. The data must be trivially copyable.
+template<typename T>
+class MappedSearchRingBuffer
+{
+  static_assert(std::is_trivially_copyable_v<T>, "MappedSearchRingBuffer data must be trivially copyable");
+
+  using time_point = std::chrono::system_clock::time_point;
+  using rep = time_point::rep;
+
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<rep>::is_always_lock_free,
+                "MappedSearchRingBuffer needs lock free atomics to share them between processes");
+
+public:
+  // Open the buffer in the file at path for pushing, creating it if it does not exist. The capacity is rounded up to a
+  // power of two and must match the capacity of an existing file. Only one process may have the file open for pushing.
+  MappedSearchRingBuffer(const std::string& path, const std::size_t capacity);
+
+  // Open an existing buffer read only. push() throws std::logic_error.
+  explicit MappedSearchRingBuffer(const std::string& path);
+
+  ~MappedSearchRingBuffer();
+  MappedSearchRingBuffer(const MappedSearchRingBuffer&) = delete;            // Disable copying of the class
+  MappedSearchRingBuffer& operator=(const MappedSearchRingBuffer&) = delete; // Disable assignment of the class
+
+  T    read(const time_point requestedTime) const; // Any number of threads and processes
+  void push(const time_point time, const T& item); // One thread of one process only
+  bool isEmpty() const;
+
+  // Call reader with the closest item to requestedTime in place and return its result. As with SeqLockSearchRingBuffer
+  // the reader may be called more than once, so it must only read the item and have no side effects.
+  template<typename Reader>
+  std::invoke_result_t<Reader, const T&> readWith(const time_point requestedTime, Reader&& reader) const;
+
+  std::size_t capacity() const { return static_cast<std::size_t>(mMask + 1); }
+
+  // Write the pushed data to the file and wait for it to be written. Without this the data survives the process
+  // exiting or crashing but may be lost if the machine goes down.
+  void flush();
+
+  // Exceptions
+  class BufferEmpty : public std::runtime_error
+  {
+  public:
+    BufferEmpty() : runtime_error("Error trying to read data from empty circular buffer") {}
+  };
+
+  class ItemTooOld : public std::runtime_error
+  {
+  public:
+    ItemTooOld() : runtime_error("Error trying to insert old data into the buffer") {}
+  };
+
+  class IncompatibleFile : public std::runtime_error
+  {
+  public:
+    IncompatibleFile(const std::string& reason) : runtime_error("The mapped buffer file is not compatible: " + reason) {}
+  };
+
+private:
+  static constexpr std::uint64_t magicNumber = 0x3150414d42525300; // "\0SRBMAP1" identifies the file
+  static constexpr std::uint32_t fileVersion = 1;                  // Increment when the layout changes
+  static constexpr std::size_t   cacheLineSize = 64;
+
+  // Start of the file. The time stamps follow it, then the data.
+  struct Header
+  {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t itemSize;
+    std::uint64_t capacity;
+
+    // Items are addressed by position, the number of pushes before the item was pushed. Position p is in slot p % capacity.
+    // sequence is 2 * (number of completed pushes), plus 1 while a push is being written. It is the head index.
+    alignas(cacheLineSize) std::atomic<std::uint64_t> sequence;
+  };
+
+  struct SlotOf
+  {
+    std::uint64_t mask; // capacity - 1
+    std::uint64_t operator()(const std::uint64_t position) const { return position & mask; }
+  };
+
+  int                                 mFile{ -1 };
+  void*                               mMapping{ nullptr };
+  std::size_t                         mMappingSize{ 0 };
+  bool                                mReadOnly;
+  Header*                             mHeader{ nullptr };
+  std::uint64_t                       mMask{ 0 }; // capacity - 1
+  Detail::SeqLockRing<T, rep, SlotOf> mRing;      // The sequence counter protocol over the mapped arrays. See SeqLockRing.h
+
+  // Writer only state
+  std::uint64_t mPushed{ 0 };     // Number of completed pushes
+  rep           mNewestTime{ 0 }; // Time of the last push, for the ItemTooOld check
+
+  static std::size_t roundUp(const std::size_t value, const std::size_t multiple) { return (value + multiple - 1) / multiple * multiple; }
+  static std::size_t timesOffset() { return roundUp(sizeof(Header), cacheLineSize); }
+  static std::size_t itemsOffset(const std::size_t capacity) { return roundUp(timesOffset() + capacity * sizeof(rep), cacheLineSize); }
+  static std::size_t fileSize(const std::size_t capacity) { return itemsOffset(capacity) + capacity * sizeof(T); }
+
+  [[noreturn]] void fail(const std::string& what);
+  void              map(const std::size_t size);
+  void              checkHeader(const std::size_t expectedCapacity);
+  void              unmap();
+};
+
+template<typename T>
+MappedSearchRingBuffer<T>::MappedSearchRingBuffer(const std::string& path, const std::size_t requestedCapacity) : mReadOnly(false)
+{
+  if (requestedCapacity == 0 || requestedCapacity > (std::size_t{ 1 } << 48))
+  {
+    throw std::invalid_argument("MappedSearchRingBuffer capacity must be between 1 and 2^48");
+  }
+  std::size_t capacity{ 1 };
+  while (capacity < requestedCapacity)
+  {
+    capacity *= 2;
+  }
+
+  mFile = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (mFile < 0)
+  {
+    fail("Could not open " + path);
+  }
+  if (::flock(mFile, LOCK_EX | LOCK_NB) != 0) // Stop a second process pushing to the same file
+  {
+    fail("Could not lock " + path + " for pushing");
+  }
+
+  struct stat status;
+  if (::fstat(mFile, &status) != 0)
+  {
+    fail("Could not read the size of " + path);
+  }
+
+  // A writer which stopped after sizing the file but before writing the magic number leaves a file with no magic number.
+  // Nothing can have been pushed to it and we hold the lock, so lay it out again rather than rejecting it. Only do so
+  // when the file is exactly the size we would lay out and the rest of the header is blank or already ours, so a file
+  // which merely starts with zeros is rejected below rather than overwritten.
+  struct
+  {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t itemSize;
+    std::uint64_t capacity;
+  } start{};
+  const bool sized = (static_cast<std::size_t>(status.st_size) == fileSize(capacity));
+  if (sized && ::pread(mFile, &start, sizeof(start), 0) != sizeof(start))
+  {
+    fail("Could not read " + path);
+  }
+  const bool blank = (start.version == 0 && start.itemSize == 0 && start.capacity == 0);
+  const bool ours = (start.version == fileVersion && start.itemSize == sizeof(T) && start.capacity == capacity);
+  const bool interrupted = (sized && start.magic == 0 && (blank || ours));
+
+  if (status.st_size == 0 || interrupted) // A new file, so lay it out. It is zero filled, which is an empty buffer.
+  {
+    // Truncating to 0 first zero fills any part of an interrupted layout
+    if ((interrupted && ::ftruncate(mFile, 0) != 0) || ::ftruncate(mFile, static_cast<off_t>(fileSize(capacity))) != 0)
+    {
+      fail("Could not size " + path);
+    }
+    map(fileSize(capacity));
+    mHeader->version = fileVersion;
+    mHeader->itemSize = sizeof(T);
+    mHeader->capacity = capacity;
+    std::atomic_thread_fence(std::memory_order_release);
+    mHeader->magic = magicNumber; // Written last, so a file which was not fully laid out is not mistaken for a buffer
+  }
+  else if (static_cast<std::size_t>(status.st_size) < sizeof(Header))
+  {
+    unmap();
+    throw IncompatibleFile("the file is too small");
+  }
+  else
+  {
+    map(static_cast<std::size_t>(status.st_size));
+  }
+  checkHeader(capacity);
+
+  // Carry on from the last writer. If it stopped part way through a push the sequence is odd, so readers skip that slot
+  // and the next push writes the same position again.
+  mPushed = mRing.completed();
+  mNewestTime = (mPushed != 0) ? mRing.timeAt(mPushed - 1) : 0;
+}
+
+template<typename T>
+MappedSearchRingBuffer<T>::MappedSearchRingBuffer(const std::string& path) : mReadOnly(true)
+{
+  mFile = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (mFile < 0)
+  {
+    fail("Could not open " + path);
+  }
+
+  struct stat status;
+  if (::fstat(mFile, &status) != 0)
+  {
+    fail("Could not read the size of " + path);
+  }
+  if (static_cast<std::size_t>(status.st_size) < sizeof(Header))
+  {
+    unmap();
+    throw IncompatibleFile("the file is too small");
+  }
+  map(static_cast<std::size_t>(status.st_size));
+  checkHeader(0);
+}
+
+template<typename T>
+MappedSearchRingBuffer<T>::~MappedSearchRingBuffer()
+{
+  unmap();
+}
+
+template<typename T>
+void
+MappedSearchRingBuffer<T>::fail(const std::string& what)
+{
+  const int error = errno;
+  unmap();
+  throw std::system_error(error, std::generic_category(), what);
+}
+
+template<typename T>
+void
+MappedSearchRingBuffer<T>::map(const std::size_t size)
+{
+  const int protection = mReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+  void*     mapping = ::mmap(nullptr, size, protection, MAP_SHARED, mFile, 0);
+  if (mapping == MAP_FAILED)
+  {
+    fail("Could not map the buffer file");
+  }
+  mMapping = mapping;
+  mMappingSize = size;
+  mHeader = static_cast<Header*>(mMapping);
+}
+
+// Checks the file was written by a compatible version for the same type and capacity, then finds the arrays.
+// An expectedCapacity of 0 accepts any capacity.
+template<typename T>
+void
+MappedSearchRingBuffer<T>::checkHeader(const std::size_t expectedCapacity)
+{
+  std::string problem;
+  if (mHeader->magic != magicNumber)
+  {
+    problem = "it is not a buffer file";
+  }
+  else if (mHeader->version != fileVersion)
+  {
+    problem = "it is version " + std::to_string(mHeader->version) + " but version " + std::to_string(fileVersion) + " is needed";
+  }
+  else if (mHeader->itemSize != sizeof(T))
+  {
+    problem = "it holds items of " + std::to_string(mHeader->itemSize) + " bytes but these are " + std::to_string(sizeof(T));
+  }
+  else if (mHeader->capacity == 0 || (mHeader->capacity & (mHeader->capacity - 1)) != 0 ||
+           (expectedCapacity != 0 && mHeader->capacity != expectedCapacity))
+  {
+    problem = "it has a capacity of " + std::to_string(mHeader->capacity);
+  }
+  else if (mMappingSize != fileSize(mHeader->capacity))
+  {
+    problem = "its size does not match its capacity";
+  }
+
+  if (!problem.empty())
+  {
+    unmap();
+    throw IncompatibleFile(problem);
+  }
+
+  mMask = mHeader->capacity - 1;
+  mRing = Detail::SeqLockRing<T, rep, SlotOf>(&mHeader->sequence,
+                                              reinterpret_cast<std::atomic<rep>*>(static_cast<char*>(mMapping) + timesOffset()),
+                                              reinterpret_cast<T*>(static_cast<char*>(mMapping) + itemsOffset(mHeader->capacity)),
+                                              mHeader->capacity,
+                                              SlotOf{ mMask });
+}
+
+template<typename T>
+void
+MappedSearchRingBuffer<T>::unmap()
+{
+  if (mMapping != nullptr)
+  {
+    ::munmap(mMapping, mMappingSize);
+    mMapping = nullptr;
+  }
+  if (mFile >= 0)
+  {
+    ::close(mFile); // Also releases the lock
+    mFile = -1;
+  }
+}
+
+template<typename T>
+void
+MappedSearchRingBuffer<T>::push(const time_point time, const T& item)
+{
+  if (mReadOnly)
+  {
+    throw std::logic_error("Cannot push to a MappedSearchRingBuffer opened read only");
+  }
+
+  const rep stamp = time.time_since_epoch().count();
+  if (mPushed != 0 && stamp < mNewestTime) // If the inserted time is less than latest time then cancel the insertion
+  {
+    throw ItemTooOld{};
+  }
+
+  mRing.write(mPushed, stamp, item);
+  ++mPushed;
+  mNewestTime = stamp;
+}
+
+template<typename T>
+void
+MappedSearchRingBuffer<T>::flush()
+{
+  if (!mReadOnly && ::msync(mMapping, mMappingSize, MS_SYNC) != 0)
+  {
+    throw std::system_error(errno, std::generic_category(), "Could not flush the buffer file");
+  }
+}
+
+template<typename T>
+T
+MappedSearchRingBuffer<T>::read(const time_point requestedTime) const
+{
+  return readWith(requestedTime, [](const T& item) {
+    alignas(T) unsigned char copy[sizeof(T)]; // Raw storage, so T need not be default constructible
+    std::memcpy(copy, &item, sizeof(T));
+    return *std::launder(reinterpret_cast<const T*>(copy));
+  });
+}
+
+template<typename T>
+template<typename Reader>
+std::invoke_result_t<Reader, const T&>
+MappedSearchRingBuffer<T>::readWith(const time_point requestedTime, Reader&& reader) const
+{
+  return mRing.template readWith<BufferEmpty>(requestedTime.time_since_epoch().count(), std::forward<Reader>(reader));
+}
+
+template<typename T>
+bool
+MappedSearchRingBuffer<T>::isEmpty() const
+{
+  return mRing.isEmpty();
+}
+
+} // End namespace Concurrent
+#endif // End header guard
@@ -0,0 +1,162 @@
+#ifndef CONCURRENT_RINGSTORAGE_H
+#define CONCURRENT_RINGSTORAGE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace Concurrent
+{
+
+// Use as the SIZE of a SearchRingBuffer to choose the capacity at run time
+inline constexpr std::size_t dynamicExtent = std::numeric_limits<std::size_t>::max();
+
+// How the storage of a run time sized buffer is allocated
+struct HeapOptions
+{
+  std::size_t alignment = 64;    // Alignment of the time stamp and data arrays in bytes. Must be a power of two.
+  bool        hugePages = false; // Ask the OS to back the arrays with huge pages (Linux only, ignored elsewhere)
+};
+
+namespace Detail
+{
+
+// Time stamp and data arrays of a SearchRingBuffer, with the time stamps kept apart from the data so searching only
+// touches time stamps. Indices wrap from capacity() - 1 back to 0.
+template<typename Key, typename T, std::size_t SIZE>
+class RingStorage
+{
+public:
+  static constexpr std::size_t capacity() { return SIZE; }
+
+  Key*       times() { return mTimes.data(); }
+  const Key* times() const { return mTimes.data(); }
+  T*         items() { return mItems.data(); }
+  const T*   items() const { return mItems.data(); }
+
+  // A power of two capacity wraps with a mask rather than a branch
+  static constexpr std::size_t
+  next(const std::size_t index)
+  {
+    if constexpr ((SIZE & (SIZE - 1)) == 0)
+    {
+      return (index + 1) & (SIZE - 1);
+    }
+    else
+    {
+      return (index == SIZE - 1) ? 0 : index + 1;
+    }
+  }
+
+private:
+  std::array<Key, SIZE> mTimes;
+  std::array<T, SIZE>   mItems;
+};
+
+// Heap allocated storage. The capacity is rounded up to a power of two so indices always wrap with a mask.
+template<typename Key, typename T>
+class RingStorage<Key, T, dynamicExtent>
+{
+public:
+  RingStorage(const std::size_t requestedCapacity, const HeapOptions& options) :
+      mCapacity(roundUpToPowerOfTwo(requestedCapacity)),
+      mTimes(allocate<Key>(mCapacity, options)),
+      mItems(allocate<T>(mCapacity, options))
+  {
+  }
+
+  std::size_t capacity() const { return mCapacity; }
+
+  Key*       times() { return mTimes.get(); }
+  const Key* times() const { return mTimes.get(); }
+  T*         items() { return mItems.get(); }
+  const T*   items() const { return mItems.get(); }
+
+  std::size_t next(const std::size_t index) const { return (index + 1) & (mCapacity - 1); }
+
+private:
+  // Destroys the objects and frees the memory allocated by allocate()
+  template<typename U>
+  struct Deleter
+  {
+    std::size_t count;
+    std::size_t alignment;
+
+    void
+    operator()(U* objects) const
+    {
+      std::destroy_n(objects, count);
+      ::operator delete(objects, std::align_val_t(alignment));
+    }
+  };
+
+  template<typename U>
+  using Array = std::unique_ptr<U[], Deleter<U>>;
+
+  std::size_t mCapacity;
+  Array<Key>  mTimes;
+  Array<T>    mItems;
+
+  static std::size_t
+  roundUpToPowerOfTwo(const std::size_t requested)
+  {
+    if (requested == 0 || requested > (std::numeric_limits<std::size_t>::max() / 2) + 1)
+    {
+      throw std::invalid_argument("SearchRingBuffer capacity must be between 1 and 2^63");
+    }
+    std::size_t capacity{ 1 };
+    while (capacity < requested)
+    {
+      capacity *= 2;
+    }
+    return capacity;
+  }
+
+  template<typename U>
+  static Array<U>
+  allocate(const std::size_t count, const HeapOptions& options)
+  {
+    constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+
+    std::size_t alignment = std::max(options.alignment, alignof(U));
+    std::size_t bytes = count * sizeof(U);
+    if (options.hugePages)
+    {
+      // Huge pages can only back whole, aligned huge pages
+      alignment = std::max(alignment, hugePageSize);
+      bytes = (bytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+    }
+
+    void* memory = ::operator new(bytes, std::align_val_t(alignment));
+#if defined(__linux__)
+    if (options.hugePages)
+    {
+      madvise(memory, bytes, MADV_HUGEPAGE); // Only a hint. If it fails normal pages are used.
+    }
+#endif
+
+    U* objects = static_cast<U*>(memory);
+    try
+    {
+      std::uninitialized_value_construct_n(objects, count);
+    }
+    catch (...)
+    {
+      ::operator delete(memory, std::align_val_t(alignment));
+      throw;
+    }
+    return Array<U>(objects, Deleter<U>{ count, alignment });
+  }
+};
+
+} // End namespace Detail
+} // End namespace Concurrent
+#endif // End header guard
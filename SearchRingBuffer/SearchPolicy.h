@@ -0,0 +1,80 @@
+#ifndef CONCURRENT_SEARCHPOLICY_H
+#define CONCURRENT_SEARCHPOLICY_H
+
+#include <cstddef>
+
+#include "KeyTraits.h"
+#include "SimdSearch.h"
+
+namespace Concurrent
+{
+
+// Search policies find the first time stamp in the sorted range [first, last) which does not compare less than value,
+// with the same result as std::lower_bound. SearchRingBuffer uses them on each sorted half of the ring.
+
+// O(log(SIZE)) binary search. Makes no assumption about how the time stamps are spaced.
+struct BinarySearch
+{
+  template<typename Key>
+  static const Key*
+  lowerBound(const Key* first, const Key* last, const Key& value)
+  {
+    return Detail::lowerBound(first, last, value);
+  }
+};
+
+// Guesses the position from where value lies between the first and last time stamps, then corrects the guess by
+// stepping through neighbouring time stamps. For evenly spaced time stamps (e.g. fixed rate sensors) the guess is
+// exact or very close, making lookups close to O(1).
+// If the guess is more than MaxScan time stamps out the spacing is irregular, so it falls back to a binary search
+// of the remaining range.
+template<std::size_t MaxScan = 8>
+struct InterpolationSearch
+{
+  template<typename Key>
+  static const Key*
+  lowerBound(const Key* first, const Key* last, const Key& value)
+  {
+    const std::ptrdiff_t count = last - first;
+    if (count == 0 || !(*first < value))
+    {
+      return first;
+    }
+    if (*(last - 1) < value)
+    {
+      return last;
+    }
+
+    // *first < value <= *(last - 1), so there are at least 2 time stamps and the span is not zero
+    const double fraction = Detail::toDouble(value - *first) / Detail::toDouble(*(last - 1) - *first);
+    const Key*   position = first + static_cast<std::ptrdiff_t>(fraction * static_cast<double>(count - 1));
+    std::size_t  steps{ 0 };
+
+    if (*position < value) // The guess is too low so step forwards
+    {
+      while (position != last && *position < value)
+      {
+        if (++steps > MaxScan)
+        {
+          return Detail::lowerBound(position, last, value);
+        }
+        ++position;
+      }
+    }
+    else // The guess may be too high so step backwards
+    {
+      while (position != first && !(*(position - 1) < value))
+      {
+        if (++steps > MaxScan)
+        {
+          return Detail::lowerBound(first, position, value);
+        }
+        --position;
+      }
+    }
+    return position;
+  }
+};
+
+} // End namespace Concurrent
+#endif // End header guard
@@ -4,26 +4,110 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <iterator>
 #include <mutex>
+#include <new>
+#include <optional>
 #include <shared_mutex>
+#include <type_traits>
+
+#include "BufferStats.h"
+#include "Interpolate.h"
+#include "KeyTraits.h"
+#include "RingStorage.h"
+#include "SearchPolicy.h"
 
 namespace Concurrent
 {
 
-template<typename T, std::size_t SIZE>
-class SearchRingBuffer
+// Result of SearchRingBuffer::tryPush()
+enum class PushStatus
+{
+  Pushed,    // The item was inserted
+  ItemTooOld // The item was older than the newest item so was not inserted
+};
+
+// SearchPolicy decides how the sorted time stamps are searched. See SearchPolicy.h
+// A SIZE of dynamicExtent chooses the capacity at run time and allocates the storage on the heap. See RingStorage.h
+// Key is the type of the time stamps. It can be any totally ordered type whose values can be subtracted, for example a
+// std::chrono::time_point of any clock, or an integer such as a cycle count or sequence number.
+// StatsPolicy decides whether the buffer counts its activity for stats(). See BufferStats.h
+// The policy is a private base so the default NoBufferStats takes up no space.
+template<typename T,
+         std::size_t SIZE,
+         class SearchPolicy = BinarySearch,
+         typename Key = std::chrono::system_clock::time_point,
+         class StatsPolicy = NoBufferStats>
+class SearchRingBuffer : private StatsPolicy
 {
-  using time_point = std::chrono::system_clock::time_point;
+  using Difference = Detail::KeyDifference<Key>;
 
 public:
   SearchRingBuffer();
+
+  // Only for SIZE == dynamicExtent. The capacity is rounded up to a power of two.
+  template<std::size_t S = SIZE, std::enable_if_t<S == dynamicExtent, int> = 0>
+  explicit SearchRingBuffer(const std::size_t capacity, const HeapOptions& options = HeapOptions{});
   SearchRingBuffer(const SearchRingBuffer&) = delete;            // Disable copying of the class //TODO
   SearchRingBuffer& operator=(const SearchRingBuffer&) = delete; // Disable assignment of the class //TODO
 
-  T    read(const time_point requestedTime) const;
-  void push(const time_point time, const T& item);
+  T    read(const Key requestedTime) const;
+  void push(const Key time, const T& item);
   bool isEmpty() const;
 
+  std::size_t capacity() const { return mStorage.capacity(); }
+
+  // Accept items up to lateness older than the newest item, inserting them in time order instead of rejecting them.
+  // Each late item moves the items newer than it up one place, so keep the window small. The default is zero.
+  // The moves must not throw, since a shift which stopped part way would leave the buffer out of time order.
+  void setMaxLateness(const Difference lateness);
+
+  // Call reader with the closest item to requestedTime and return its result. The item is not copied.
+  // The reader runs under the reader lock so it must not push to this buffer.
+  template<typename Reader>
+  std::invoke_result_t<Reader, const T&> readWith(const Key requestedTime, Reader&& reader) const;
+
+  // Construct the item directly in the buffer from args
+  template<typename... Args>
+  void emplace(const Key time, Args&&... args);
+
+  // Versions of push(), emplace() and read() which report an old item or an empty buffer without throwing, for paths
+  // where those are routine rather than errors
+  template<typename... Args>
+  PushStatus       tryEmplace(const Key time, Args&&... args);
+  PushStatus       tryPush(const Key time, const T& item);
+  std::optional<T> tryRead(const Key requestedTime) const;
+
+  // Push a batch of (time, item) pairs, e.g. std::pair<Key, T>, under one lock. The whole batch is checked before
+  // anything is inserted, so if any time is older than the one before it ItemTooOld is thrown and the buffer is unchanged.
+  // If the batch is larger than the buffer only the newest capacity() items are kept. setMaxLateness() does not apply.
+  // If copying an item throws, the items before it stay pushed and the buffer remains valid.
+  template<typename ForwardIt>
+  void pushRange(ForwardIt first, ForwardIt last);
+
+  // Copy every item with a time stamp in [from, to] to out, oldest first. Returns the end of the output.
+  template<typename OutputIt>
+  OutputIt readRange(const Key from, const Key to, OutputIt out) const;
+
+  // Call visitor(time, item) for every item with a time stamp in [from, to], oldest first.
+  // The visitor runs under the reader lock so it must not push to this buffer.
+  template<typename Visitor>
+  void forEachInRange(const Key from, const Key to, Visitor&& visitor) const;
+
+  // Read the closest item to each time in [first, last) under one lock, writing them to out in the same order.
+  // The result is the same as calling read() for each time. Sorted times are found by galloping forwards from the
+  // previous result, so N sorted times cost about N + log(SIZE) compares rather than N * log(SIZE).
+  template<typename InputIt, typename OutputIt>
+  OutputIt readMany(InputIt first, InputIt last, OutputIt out) const;
+
+  // Linearly interpolate between the items either side of requestedTime, using Interpolate<T> (see Interpolate.h).
+  // Both items are found with one search under one lock. Times outside the buffer give the oldest or newest item.
+  T readInterpolated(const Key requestedTime) const;
+
+  // Snapshot of the counters, taken under the writer lock so they are consistent with each other.
+  // Only available with a StatsPolicy which keeps statistics, such as CountBufferStats.
+  BufferStats stats() const;
+
   // Exceptions
   class BufferEmpty : public std::runtime_error
   {
@@ -38,108 +122,543 @@ public:
   };
 
 private:
-  using iterator = typename std::array<std::pair<time_point, T>, SIZE>::iterator;
-  using const_iterator = typename std::array<std::pair<time_point, T>, SIZE>::const_iterator;
+  // The time stamps are kept in their own array rather than alongside the data so the binary search only touches densely
+  // packed time stamps. The data is only loaded for the item which is found.
+  mutable std::shared_mutex         mMutex;       // Mutex to control multithreaded access
+  Detail::RingStorage<Key, T, SIZE> mStorage;     // Time stamps and data. times()[i] is the time stamp of items()[i]
+  std::size_t                       mNewest;      // Index of the last element inserted
+  std::size_t                       mOldest;      // Index of the oldest element inserted
+  bool                              mFull;        // Flag set to true once size == capacity
+  bool                              mEmpty;       // Flag set to false once first element is inserted
+  Difference                        mMaxLateness; // How much older than the newest item an inserted item may be
+
+  Key*       times() { return mStorage.times(); }
+  const Key* times() const { return mStorage.times(); }
+  T*         items() { return mStorage.items(); }
+  const T*   items() const { return mStorage.items(); }
+
+  // Increment the index by one except if index is the last element
+  // then wrap round back to the first element. Power of two capacities wrap with a mask instead of a branch.
+  std::size_t nextIndex(const std::size_t index) const { return mStorage.next(index); }
+  std::size_t previousIndex(const std::size_t index) const { return (index == 0) ? capacity() - 1 : index - 1; }
 
-  mutable std::shared_mutex                  mMutex;  // Mutex to control multithreaded access
-  std::array<std::pair<time_point, T>, SIZE> mBuffer; // Underlying buffer
-  iterator                                   mNewest; // Iterator to the last element inserted
-  iterator                                   mOldest; // Iterator to the oldest element inserted
-  bool                                       mFull;   // Flag set to true once size == capacity
-  bool                                       mEmpty;  // Flag set to false once first element is inserted
+  // Slot of the item which is offset places newer than the oldest item
+  std::size_t slotOf(const std::size_t offset) const;
 
-  // Increment the iterator by one item except if iterator points to the last element
-  // then wrap round back to the first element
-  iterator nextIter(const iterator& iter);
+  // Move mNewest on to the slot which has just been written, and mOldest too if the buffer was already full
+  void advanceNewest();
+
+  // Write an item no older than the newest item into the next slot. Must be called with the writer lock held.
+  template<typename... Args>
+  void emplaceNewest(const Key time, Args&&... args);
+
+  // Insert an item older than the newest item by moving the newer items up one slot
+  PushStatus insertLate(const Key time, T&& item);
+
+  // Visit the items in [from, to] within the sorted slots [begin, end)
+  template<typename Visitor>
+  void visitSpan(const std::size_t begin, const std::size_t end, const Key from, const Key to, Visitor& visitor) const;
 
   // Split the array into two arrays using mNewest as the splitting point
-  // Determine which array the value is in and binary search for it.
-  T findItem(const time_point requestedTime) const;
+  // Determine which array the value is in and search for the first time stamp which does not compare less than
+  // requestedTime. requestedTime must be within the buffered times.
+  std::size_t findAbove(const Key requestedTime) const;
+
+  // Index of the closest time stamp to requestedTime, which must be within the buffered times
+  std::size_t findIndex(const Key requestedTime) const;
+
+  // Index of the closest time stamp to requestedTime. The buffer must not be empty.
+  std::size_t closestIndex(const Key requestedTime) const;
 };
 
-template<typename T, std::size_t SIZE>
-SearchRingBuffer<T, SIZE>::SearchRingBuffer() :
+// SearchRingBuffer with its capacity chosen at run time
+template<typename T, class SearchPolicy = BinarySearch, typename Key = std::chrono::system_clock::time_point, class StatsPolicy = NoBufferStats>
+using DynamicSearchRingBuffer = SearchRingBuffer<T, dynamicExtent, SearchPolicy, Key, StatsPolicy>;
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::SearchRingBuffer() :
+    mNewest(SIZE - 1), // Initialised to last place in array so initial nextIndex() puts its to first place
+    mOldest(0),
+    mFull(false),
+    mEmpty(true),
+    mMaxLateness(Difference{})
+{
+  static_assert(SIZE != dynamicExtent, "A SearchRingBuffer with a SIZE of dynamicExtent must be given a capacity");
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+template<std::size_t S, std::enable_if_t<S == dynamicExtent, int>>
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::SearchRingBuffer(const std::size_t capacity, const HeapOptions& options) :
+    mStorage(capacity, options),
+    mNewest(mStorage.capacity() - 1),
+    mOldest(0),
     mFull(false),
     mEmpty(true),
-    mNewest(std::prev(mBuffer.end())), // Initialised to last place in array so initial nextIter() puts its to first place
-    mOldest(mBuffer.begin())
+    mMaxLateness(Difference{})
 {
 }
 
-template<typename T, std::size_t SIZE>
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
 void
-SearchRingBuffer<T, SIZE>::push(const time_point time, const T& item)
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::push(const Key time, const T& item)
 {
-  std::scoped_lock<std::shared_mutex> aScopedLock(mMutex);
+  emplace(time, item);
+}
 
-  if (!mEmpty && time < mNewest->first) // If the inserted time is less than latest time then cancel the insertion
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+template<typename... Args>
+void
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::emplace(const Key time, Args&&... args)
+{
+  if (tryEmplace(time, std::forward<Args>(args)...) == PushStatus::ItemTooOld)
   {
     throw ItemTooOld{};
   }
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+PushStatus
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::tryPush(const Key time, const T& item)
+{
+  return tryEmplace(time, item);
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+template<typename... Args>
+PushStatus
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::tryEmplace(const Key time, Args&&... args)
+{
+  std::scoped_lock<std::shared_mutex> aScopedLock(mMutex);
+
+  if (!mEmpty && time < times()[mNewest]) // The inserted time is less than latest time
+  {
+    if (times()[mNewest] - time > mMaxLateness) // Too late, so cancel the insertion
+    {
+      StatsPolicy::onReject();
+      return PushStatus::ItemTooOld;
+    }
+    return insertLate(time, T(std::forward<Args>(args)...));
+  }
+
+  emplaceNewest(time, std::forward<Args>(args)...);
+  return PushStatus::Pushed;
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+template<typename... Args>
+void
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::emplaceNewest(const Key time, Args&&... args)
+{
+  const std::size_t slot = nextIndex(mNewest);
+  if constexpr (std::is_nothrow_constructible_v<T, Args...>)
+  {
+    // Replace the old data by constructing straight over it
+    items()[slot].~T();
+    new (&items()[slot]) T(std::forward<Args>(args)...);
+  }
   else
   {
-    mNewest = nextIter(mNewest);
-    *mNewest = std::make_pair(time, item); // Write the data
-    mEmpty = false;
+    // Construction may throw, so construct first and then move it in. The old data stays valid if construction fails.
+    items()[slot] = T(std::forward<Args>(args)...);
   }
+  times()[slot] = time;
+  advanceNewest();
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+void
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::setMaxLateness(const Difference lateness)
+{
+  // Late items are only inserted once a lateness is set, so this guards every call to insertLate()
+  static_assert(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_copy_assignable_v<Key>,
+                "Late items can only be inserted when moving the data and assigning the keys cannot throw");
+
+  std::scoped_lock<std::shared_mutex> aScopedLock(mMutex);
+  mMaxLateness = lateness;
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+void
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::advanceNewest()
+{
+  mNewest = nextIndex(mNewest);
+  mEmpty = false;
+  StatsPolicy::onPush(1);
 
   if (!mFull) // Check if the buffer is now full
   {
-    mFull = (mNewest == std::prev(mBuffer.end()));
+    mFull = (mNewest == capacity() - 1);
   }
   else
   {
-    mOldest = nextIter(mOldest); // Move the mOldest iter to the next place
+    mOldest = nextIndex(mOldest); // Move the mOldest index to the next place
+    StatsPolicy::onOverwrite(1);
+  }
+}
+
+// Late items are near the newest end, so walk back from the newest item to count how many are newer than the late one.
+// Then move each of those up one slot, starting with the newest into the free slot (the oldest slot if the buffer is full),
+// and put the late item in the gap left behind. An item equal in time to existing items goes after them.
+// None of the moves can throw (see setMaxLateness()), so the shift always completes and the buffer stays sorted.
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+PushStatus
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::insertLate(const Key time, T&& item)
+{
+  const std::size_t size = mFull ? capacity() : mNewest + 1;
+  std::size_t       newer{ 0 };
+  for (std::size_t slot = mNewest; newer < size && time < times()[slot]; slot = previousIndex(slot))
+  {
+    ++newer;
+  }
+  if (newer == size && mFull) // Older than every item, so it would be the item overwritten
+  {
+    StatsPolicy::onReject();
+    return PushStatus::ItemTooOld;
+  }
+
+  std::size_t gap = nextIndex(mNewest);
+  for (std::size_t moved = 0; moved != newer; ++moved)
+  {
+    const std::size_t below = previousIndex(gap);
+    times()[gap] = times()[below];
+    items()[gap] = std::move(items()[below]);
+    gap = below;
+  }
+  times()[gap] = time;
+  items()[gap] = std::move(item);
+
+  advanceNewest();
+  return PushStatus::Pushed;
+}
+
+// Once checked the batch is written as at most two runs of slots, one up to the end of the arrays and one from the start,
+// and the indices are updated once at the end. That leaves the buffer unsorted if a copy throws part way through, so
+// types whose copies may throw are pushed one at a time instead, keeping the buffer valid after every item.
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+template<typename ForwardIt>
+void
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::pushRange(ForwardIt first, ForwardIt last)
+{
+  static_assert(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>,
+                "pushRange() reads the batch twice so needs forward iterators");
+
+  std::scoped_lock<std::shared_mutex> aScopedLock(mMutex);
+
+  if (first == last)
+  {
+    return;
+  }
+
+  Key         previous = mEmpty ? (*first).first : times()[mNewest];
+  std::size_t count{ 0 };
+  for (ForwardIt it = first; it != last; ++it, ++count)
+  {
+    if ((*it).first < previous) // Check the whole batch before changing anything
+    {
+      StatsPolicy::onReject();
+      throw ItemTooOld{};
+    }
+    previous = (*it).first;
+  }
+
+  // Only the newest capacity() items of the batch can be kept
+  const std::size_t sizeBefore = mEmpty ? 0 : (mFull ? capacity() : mNewest + 1);
+  const std::size_t skipped = (count > capacity()) ? count - capacity() : 0;
+  std::advance(first, skipped);
+  count -= skipped;
+
+  using Item = typename std::iterator_traits<ForwardIt>::reference;
+  if constexpr (!std::is_nothrow_assignable_v<Key&, decltype((std::declval<Item>().first))> ||
+                !std::is_nothrow_assignable_v<T&, decltype((std::declval<Item>().second))>)
+  {
+    StatsPolicy::onPush(skipped);
+    StatsPolicy::onOverwrite(skipped);
+    for (; first != last; ++first)
+    {
+      emplaceNewest((*first).first, (*first).second);
+    }
+    return;
+  }
+
+  const std::size_t start = nextIndex(mNewest);
+  const std::size_t untilEnd = std::min(count, capacity() - start);
+  for (std::size_t slot = start; slot != start + untilEnd; ++slot, ++first)
+  {
+    times()[slot] = (*first).first;
+    items()[slot] = (*first).second;
+  }
+  for (std::size_t slot = 0; slot != count - untilEnd; ++slot, ++first)
+  {
+    times()[slot] = (*first).first;
+    items()[slot] = (*first).second;
+  }
+
+  mNewest = (untilEnd == count) ? start + count - 1 : count - untilEnd - 1;
+  mEmpty = false;
+  if (sizeBefore + count >= capacity())
+  {
+    mFull = true;
+    mOldest = nextIndex(mNewest);
+  }
+  StatsPolicy::onPush(skipped + count);
+  if (sizeBefore + skipped + count > capacity())
+  {
+    StatsPolicy::onOverwrite(sizeBefore + skipped + count - capacity());
   }
 }
 
-template<typename T, std::size_t SIZE>
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
 T
-SearchRingBuffer<T, SIZE>::read(const time_point requestedTime) const
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::read(const Key requestedTime) const
+{
+  return readWith(requestedTime, [](const T& item) { return item; });
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+template<typename Reader>
+std::invoke_result_t<Reader, const T&>
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::readWith(const Key requestedTime, Reader&& reader) const
 {
   std::shared_lock<std::shared_mutex> aSharedLock(mMutex);
+  StatsPolicy::onRead(1);
 
   if (mEmpty) // Check the buffer is not empty
   {
     throw BufferEmpty{};
   }
-  else if (requestedTime < mOldest->first) // Check if the requested data is too old
+  return reader(items()[closestIndex(requestedTime)]);
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+std::optional<T>
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::tryRead(const Key requestedTime) const
+{
+  std::shared_lock<std::shared_mutex> aSharedLock(mMutex);
+  StatsPolicy::onRead(1);
+
+  if (mEmpty) // Check the buffer is not empty
   {
-    return mOldest->second;
+    return std::nullopt;
   }
-  else if (requestedTime > mNewest->first) // Check if the requested data is too new
+  return items()[closestIndex(requestedTime)];
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+std::size_t
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::closestIndex(const Key requestedTime) const
+{
+  if (requestedTime < times()[mOldest]) // Check if the requested data is too old
   {
-    return mNewest->second;
+    return mOldest;
+  }
+  else if (requestedTime > times()[mNewest]) // Check if the requested data is too new
+  {
+    return mNewest;
   }
   else // We know the requested data is within the limits of the buffer
   {
-    return findItem(requestedTime);
+    return findIndex(requestedTime);
   }
 }
 
-template<typename T, std::size_t SIZE>
-bool
-SearchRingBuffer<T, SIZE>::isEmpty() const
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+T
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::readInterpolated(const Key requestedTime) const
 {
   std::shared_lock<std::shared_mutex> aSharedLock(mMutex);
-  return mEmpty;
+  StatsPolicy::onRead(1);
+
+  const Key* const times = this->times();
+  if (mEmpty) // Check the buffer is not empty
+  {
+    throw BufferEmpty{};
+  }
+  else if (!(times[mOldest] < requestedTime)) // Check if the requested data is too old
+  {
+    return items()[mOldest];
+  }
+  else if (requestedTime > times[mNewest]) // Check if the requested data is too new
+  {
+    return items()[mNewest];
+  }
+
+  const std::size_t above = findAbove(requestedTime);
+  if (times[above] == requestedTime)
+  {
+    return items()[above];
+  }
+
+  // times[below] < requestedTime < times[above], so the span is not zero
+  const std::size_t below = previousIndex(above);
+  const double      fromBelow = Detail::toDouble(requestedTime - times[below]);
+  const double      span = Detail::toDouble(times[above] - times[below]);
+  return Interpolate<T>::lerp(items()[below], items()[above], fromBelow / span);
 }
 
-template<typename T, std::size_t SIZE>
-typename SearchRingBuffer<T, SIZE>::iterator
-SearchRingBuffer<T, SIZE>::nextIter(const iterator& iter)
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+template<typename OutputIt>
+OutputIt
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::readRange(const Key from, const Key to, OutputIt out) const
 {
-  if (iter == std::prev(mBuffer.end())) // If iterator is currently pointing to last element
+  forEachInRange(from, to, [&out](const Key&, const T& item) { *out++ = item; });
+  return out;
+}
+
+// In time order the items are the slots [mOldest, end of the first span) followed by [0, end of the second span).
+// The second span is only used once the buffer has wrapped. Each span is sorted so the first item in the range is
+// found with one search and the rest are visited in order until one is newer than to.
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+template<typename Visitor>
+void
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::forEachInRange(const Key from, const Key to, Visitor&& visitor) const
+{
+  std::shared_lock<std::shared_mutex> aSharedLock(mMutex);
+  StatsPolicy::onRead(1);
+
+  if (mEmpty || to < from)
   {
-    return mBuffer.begin(); // Then wrap around and point to the first
+    return;
   }
-  else
+
+  const bool wrapped = (mOldest > mNewest);
+  visitSpan(mOldest, wrapped ? capacity() : mNewest + 1, from, to, visitor);
+  if (wrapped)
+  {
+    visitSpan(0, mNewest + 1, from, to, visitor);
+  }
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+std::size_t
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::slotOf(const std::size_t offset) const
+{
+  const std::size_t untilEnd = capacity() - mOldest; // Number of slots from the oldest item to the end of the array
+  return (offset < untilEnd) ? mOldest + offset : offset - untilEnd;
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+template<typename Visitor>
+void
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::visitSpan(const std::size_t begin,
+                                                        const std::size_t end,
+                                                        const Key         from,
+                                                        const Key         to,
+                                                        Visitor&          visitor) const
+{
+  const Key* const times = this->times();
+  if (to < times[begin] || times[end - 1] < from) // The span is entirely outside the range
+  {
+    return;
+  }
+
+  for (std::size_t i = SearchPolicy::lowerBound(times + begin, times + end, from) - times; i != end && !(to < times[i]); ++i)
+  {
+    visitor(times[i], items()[i]);
+  }
+}
+
+// Works on offsets from the oldest item, which are in time order however the buffer has wrapped.
+// The first offset whose time does not compare less than the requested time is found by doubling the step from the
+// previous result until it is passed, then binary searching the last step. The closest item is then picked as read() does.
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+template<typename InputIt, typename OutputIt>
+OutputIt
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::readMany(InputIt first, InputIt last, OutputIt out) const
+{
+  std::shared_lock<std::shared_mutex> aSharedLock(mMutex);
+
+  if (first == last)
+  {
+    return out;
+  }
+  if (mEmpty)
   {
-    return std::next(iter); // Othewise progress to the next element
+    throw BufferEmpty{};
   }
+
+  const Key* const  times = this->times();
+  const std::size_t count = mFull ? capacity() : mNewest + 1;
+  const auto        timeAt = [&](const std::size_t offset) -> const Key& { return times[slotOf(offset)]; };
+
+  std::size_t cursor{ 0 }; // First offset whose time does not compare less than the previous requested time
+  Key         previous = times[mOldest];
+  std::size_t requested{ 0 };
+  for (; first != last; ++first, ++requested)
+  {
+    const Key requestedTime = *first;
+    if (requestedTime < previous) // Not sorted, so start again from the oldest item
+    {
+      cursor = 0;
+    }
+    previous = requestedTime;
+
+    if (!(timeAt(0) < requestedTime)) // Check if the requested data is too old
+    {
+      cursor = 0;
+    }
+    else if (timeAt(count - 1) < requestedTime) // Check if the requested data is too new
+    {
+      cursor = count - 1;
+    }
+    else if (timeAt(cursor) < requestedTime) // We know timeAt(0) < requestedTime <= timeAt(count - 1)
+    {
+      // Gallop forwards until the step passes the requested time. timeAt(low) < requestedTime <= timeAt(high)
+      std::size_t low = cursor;
+      std::size_t step{ 1 };
+      while (low + step < count - 1 && timeAt(low + step) < requestedTime)
+      {
+        low += step;
+        step *= 2;
+      }
+      std::size_t high = std::min(low + step, count - 1);
+
+      while (high - low > 1)
+      {
+        const std::size_t middle = low + (high - low) / 2;
+        if (timeAt(middle) < requestedTime)
+        {
+          low = middle;
+        }
+        else
+        {
+          high = middle;
+        }
+      }
+      cursor = high;
+    }
+
+    // If not an exact match then find the closest. cursor is only 0 if the requested time is not after the oldest.
+    std::size_t closest = cursor;
+    if (cursor != 0 && requestedTime < timeAt(cursor))
+    {
+      const auto above_diff = timeAt(cursor) - requestedTime;
+      const auto below_diff = requestedTime - timeAt(cursor - 1);
+      closest = (below_diff < above_diff) ? cursor - 1 : cursor;
+    }
+    *out++ = items()[slotOf(closest)];
+  }
+  StatsPolicy::onRead(requested);
+  return out;
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+bool
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::isEmpty() const
+{
+  std::shared_lock<std::shared_mutex> aSharedLock(mMutex);
+  return mEmpty;
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+BufferStats
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::stats() const
+{
+  static_assert(StatsPolicy::enabled, "stats() needs a StatsPolicy which keeps statistics, such as CountBufferStats");
+  std::scoped_lock<std::shared_mutex> aScopedLock(mMutex); // Hold off readers too so the counters match each other
+  return StatsPolicy::snapshot();
 }
 
-// mBuffer is sorted but the start point is not the lowest and end point is not the highest.
+// The time stamps are sorted but the start point is not the lowest and end point is not the highest.
 // This means we have two sorted arrays. For example:
 //  <----arr1---><-------arr2--->
 //  | 8 | 9 | 10 | 4 | 5 | 6 | 7 |
@@ -147,61 +666,67 @@ SearchRingBuffer<T, SIZE>::nextIter(const iterator& iter)
 //   Everything equal to and below mNewest is sorted.
 //   Everything greater than mNewest is sorted.
 // Find which array the value is in
-//   If value is greater than or equal to arr[0] then in first half
+//   If value is greater than arr[0] then in first half
 //   If value is less than or equal to arr[END] then in second half
+//   (A value equal to arr[0] is checked against the second half first, so duplicates which straddle the split still
+//   give the earliest item. If the oldest item is in slot 0 there is no second half.)
 // Perform normal binary search on whichever array the value is in
-template<typename T, std::size_t SIZE>
-T
-SearchRingBuffer<T, SIZE>::findItem(const time_point requestedTime) const
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+std::size_t
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::findAbove(const Key requestedTime) const
 {
-  const_iterator start_arr;
-  const_iterator end_arr;
+  const Key* const  times = this->times();
+  const std::size_t last = capacity() - 1;
+  std::size_t       start_arr;
+  std::size_t       end_arr;
 
   // Find which array the value is in
   // Set the start and end point for the array which the value is in
-  if (requestedTime >= mBuffer.begin()->first)
+  if (requestedTime > times[0] || mOldest == 0)
   {
     // The start to the newest (inclusive)
-    start_arr = mBuffer.begin();
+    start_arr = 0;
     end_arr = mNewest;
   }
-  else if (requestedTime <= std::prev(mBuffer.end())->first)
+  else if (requestedTime <= times[last])
   {
     // One past the newest to the end
-    start_arr = std::next(mNewest);
-    end_arr = std::prev(mBuffer.end());
+    start_arr = mNewest + 1;
+    end_arr = last;
   }
-  else //  last element > requestedTime > first element - so no binary search needed
+  else
   {
-    // find which one is closer
-    auto above_diff = mBuffer.begin()->first - requestedTime;
-    auto below_diff = requestedTime - std::prev(mBuffer.end())->first;
-    return (below_diff < above_diff) ? std::prev(mBuffer.end())->second : mBuffer.begin()->second;
+    // times[last] < requestedTime <= times[0], so the value falls between the end of the second half and the start of
+    // the first. Slot 0 is the first time stamp which does not compare less, including when requestedTime == times[0]
+    // and no duplicate of it sits at the end of the second half. No search is needed.
+    return 0;
   }
 
-  // Binary search using std::lower_bound to find the first element which does not compare less than requestedTime
-  // Use std::lower_bound and use a binary predicate comparison which will return true is the first element is less than the second
-  // Comparison lambda will use the requestedTime (pair.first) to compare
-  T    item; // Fake object needed to construct target object.
-  auto above_val =
-    std::lower_bound(start_arr, end_arr, std::make_pair(requestedTime, item), [](std::pair<time_point, T> lhs, std::pair<time_point, T> rhs) -> bool {
-      return lhs.first < rhs.first;
-    });
+  // Find the first time stamp which does not compare less than requestedTime, as std::lower_bound would
+  return SearchPolicy::lowerBound(times + start_arr, times + end_arr, requestedTime) - times;
+}
+
+template<typename T, std::size_t SIZE, class SearchPolicy, typename Key, class StatsPolicy>
+std::size_t
+SearchRingBuffer<T, SIZE, SearchPolicy, Key, StatsPolicy>::findIndex(const Key requestedTime) const
+{
+  const Key* const  times = this->times();
+  const std::size_t above = findAbove(requestedTime);
 
-  if (above_val->first == requestedTime)
+  if (times[above] == requestedTime)
   {
-    return above_val->second;
+    return above;
   }
   else // If not an exact match then find the closest
   {
     // Execution will not get here if the requested item
-    //	* is less than the first element the function
-    //  * exactly the first element
-    // So safe to do std::prev without it going out of bounds
-    auto below_val = std::prev(above_val);
-    auto above_diff = above_val->first - requestedTime;
-    auto below_diff = requestedTime - below_val->first;
-    return (below_diff < above_diff) ? below_val->second : above_val->second;
+    //	* is less than the oldest element
+    //  * exactly the oldest element
+    // So the element before above is always in the buffer
+    const std::size_t below = previousIndex(above);
+    auto              above_diff = times[above] - requestedTime;
+    auto              below_diff = requestedTime - times[below];
+    return (below_diff < above_diff) ? below : above;
   }
 }
 
@@ -0,0 +1,153 @@
+#ifndef CONCURRENT_SEQLOCKRING_H
+#define CONCURRENT_SEQLOCKRING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Concurrent
+{
+namespace Detail
+{
+
+// The sequence counter protocol shared by SeqLockSearchRingBuffer and MappedSearchRingBuffer, over arrays they own.
+// Items are addressed by position, the number of pushes before the item was pushed, and SlotOf maps a position to its
+// slot in the arrays. The sequence is 2 * (number of completed pushes), plus 1 while a push is being written.
+// One thread writes. Readers never write to shared memory; they validate their result against the sequence afterwards
+// and retry if the slots they looked at were overwritten while they were reading.
+template<typename T, typename Rep, typename SlotOf>
+class SeqLockRing
+{
+public:
+  SeqLockRing() = default;
+  SeqLockRing(std::atomic<std::uint64_t>* sequence, std::atomic<Rep>* times, T* items, const std::uint64_t size, const SlotOf slotOf) :
+      mSequence(sequence),
+      mTimes(times),
+      mItems(items),
+      mSize(size),
+      mSlotOf(slotOf)
+  {
+  }
+
+  // Number of completed pushes. A push which was interrupted part way through is not counted, so the next push
+  // writes the same position again.
+  std::uint64_t completed() const { return mSequence->load(std::memory_order_acquire) / 2; }
+  bool          isEmpty() const { return mSequence->load(std::memory_order_acquire) < 2; }
+  Rep           timeAt(const std::uint64_t position) const { return mTimes[mSlotOf(position)].load(std::memory_order_relaxed); }
+
+  // Write the item at position pushed, which must be the number of completed pushes. Writer only.
+  void write(const std::uint64_t pushed, const Rep stamp, const T& item);
+
+  // Call reader with the item closest in time to requested and return its result, or throw Empty if nothing has been pushed
+  template<typename Empty, typename Reader>
+  std::invoke_result_t<Reader, const T&> readWith(const Rep requested, Reader&& reader) const;
+
+private:
+  std::atomic<std::uint64_t>* mSequence{ nullptr };
+  std::atomic<Rep>*           mTimes{ nullptr }; // Time stamps, atomic so readers can load them while they are written
+  T*                          mItems{ nullptr }; // Data, copied by readers then validated with the sequence
+  std::uint64_t               mSize{ 0 };        // Number of slots
+  SlotOf                      mSlotOf{};
+
+  // Find the position with the closest time in [first, last]
+  std::uint64_t findPosition(const Rep requested, std::uint64_t first, std::uint64_t last) const;
+};
+
+template<typename T, typename Rep, typename SlotOf>
+void
+SeqLockRing<T, Rep, SlotOf>::write(const std::uint64_t pushed, const Rep stamp, const T& item)
+{
+  // Mark the sequence odd so readers know the slot for position pushed (the oldest item once full) is being overwritten.
+  // The release fence stops the writes below being reordered before the mark.
+  mSequence->store(2 * pushed + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const std::uint64_t slot = mSlotOf(pushed);
+  mTimes[slot].store(stamp, std::memory_order_relaxed);
+  std::memcpy(&mItems[slot], &item, sizeof(T));
+
+  mSequence->store(2 * (pushed + 1), std::memory_order_release);
+}
+
+template<typename T, typename Rep, typename SlotOf>
+template<typename Empty, typename Reader>
+std::invoke_result_t<Reader, const T&>
+SeqLockRing<T, Rep, SlotOf>::readWith(const Rep requested, Reader&& reader) const
+{
+  using Result = std::invoke_result_t<Reader, const T&>;
+  static_assert(!std::is_void_v<Result>, "The reader must return its result, as it may be called more than once");
+
+  for (;;)
+  {
+    const std::uint64_t before = mSequence->load(std::memory_order_acquire);
+    const std::uint64_t pushed = before / 2;
+    if (pushed == 0)
+    {
+      throw Empty{};
+    }
+
+    // Positions which are fully written. If a push is in progress its slot holds the oldest position, so skip that one.
+    const std::uint64_t inProgress = before % 2;
+    const std::uint64_t first = (pushed + inProgress > mSize) ? pushed + inProgress - mSize : 0;
+    const std::uint64_t last = pushed - 1;
+
+    const std::uint64_t position = findPosition(requested, first, last);
+
+    Result result = reader(static_cast<const T&>(mItems[mSlotOf(position)]));
+
+    // Check none of the slots we read have been overwritten since. Writes which have started by now cover positions
+    // [0, started), and writing position w overwrites the slot of position w - size. The search never looks below first.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t after = mSequence->load(std::memory_order_relaxed);
+    const std::uint64_t started = (after + 1) / 2;
+    if (first + mSize >= started)
+    {
+      return result;
+    }
+  }
+}
+
+// Positions are in time order so this is a normal binary search, with the same closest match rules as SearchRingBuffer.
+// Slots may be overwritten part way through, which is detected afterwards by readWith().
+template<typename T, typename Rep, typename SlotOf>
+std::uint64_t
+SeqLockRing<T, Rep, SlotOf>::findPosition(const Rep requested, std::uint64_t first, std::uint64_t last) const
+{
+  if (requested <= timeAt(first)) // Check if the requested data is too old
+  {
+    return first;
+  }
+  if (requested > timeAt(last)) // Check if the requested data is too new
+  {
+    return last;
+  }
+
+  // Find the first position which does not compare less than requested. We know timeAt(first) < requested <= timeAt(last)
+  std::uint64_t low = first + 1;
+  std::uint64_t high = last;
+  while (low < high)
+  {
+    const std::uint64_t middle = low + (high - low) / 2;
+    if (timeAt(middle) < requested)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+
+  const Rep above = timeAt(low);
+  if (above == requested)
+  {
+    return low;
+  }
+  const Rep below = timeAt(low - 1);
+  return (requested - below < above - requested) ? low - 1 : low;
+}
+
+} // End namespace Detail
+} // End namespace Concurrent
+#endif // End header guard
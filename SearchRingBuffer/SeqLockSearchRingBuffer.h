@@ -0,0 +1,125 @@
+#ifndef CONCURRENT_SEQLOCKSEARCHRINGBUFFER_H
+#define CONCURRENT_SEQLOCKSEARCHRINGBUFFER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "SeqLockRing.h"
+
+namespace Concurrent
+{
+
+// Variant of SearchRingBuffer for a single producer thread and trivially copyable, default constructible data.
+// There is no mutex. The producer publishes each push through a sequence counter and readers validate their result against it
+// afterwards, retrying if the slots they looked at were overwritten while they were reading. Readers therefore never write to
+// shared memory, so they do not contend with each other, and push() never waits for readers.
+template<typename T, std::size_t SIZE>
+class SeqLockSearchRingBuffer
+{
+  static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+                "SeqLockSearchRingBuffer data must be trivially copyable and default constructible, as the slots hold T");
+  static_assert(SIZE >= 2, "SeqLockSearchRingBuffer must hold at least 2 items");
+
+  using time_point = std::chrono::system_clock::time_point;
+  using rep = time_point::rep;
+
+public:
+  SeqLockSearchRingBuffer() = default;
+  SeqLockSearchRingBuffer(const SeqLockSearchRingBuffer&) = delete;            // Disable copying of the class
+  SeqLockSearchRingBuffer& operator=(const SeqLockSearchRingBuffer&) = delete; // Disable assignment of the class
+
+  T    read(const time_point requestedTime) const; // Any number of threads
+  void push(const time_point time, const T& item); // One thread only
+  bool isEmpty() const;
+
+  // Call reader with the closest item to requestedTime in place and return its result, without copying the item.
+  // The item may be overwritten while reader runs. If it was, the result is thrown away and reader is called again, so
+  // reader must only read the item and compute its result. It must not keep references to the item or have side effects.
+  template<typename Reader>
+  std::invoke_result_t<Reader, const T&> readWith(const time_point requestedTime, Reader&& reader) const; // Any number of threads
+
+  // Exceptions
+  class BufferEmpty : public std::runtime_error
+  {
+  public:
+    BufferEmpty() : runtime_error("Error trying to read data from empty circular buffer") {}
+  };
+
+  class ItemTooOld : public std::runtime_error
+  {
+  public:
+    ItemTooOld() : runtime_error("Error trying to insert old data into the buffer") {}
+  };
+
+private:
+  static constexpr std::size_t cacheLineSize = 64;
+
+  // Items are addressed by position, the number of pushes before the item was pushed. Position p is stored in slot p % SIZE.
+  // mSequence is 2 * (number of completed pushes), plus 1 while a push is being written.
+  alignas(cacheLineSize) std::atomic<std::uint64_t> mSequence{ 0 };
+
+  // Producer only state
+  alignas(cacheLineSize) std::uint64_t mPushed{ 0 }; // Number of completed pushes
+  rep mNewestTime{ 0 };                              // Time of the last push, for the ItemTooOld check
+
+  alignas(cacheLineSize) std::array<std::atomic<rep>, SIZE> mTimes{}; // Time stamps, atomic so readers can load them while they are written
+  std::array<T, SIZE> mItems{};                                        // Data, copied by readers then validated with mSequence
+
+  struct SlotOf
+  {
+    std::uint64_t operator()(const std::uint64_t position) const { return position % SIZE; }
+  };
+
+  // The sequence counter protocol over the arrays above. See SeqLockRing.h
+  alignas(cacheLineSize) Detail::SeqLockRing<T, rep, SlotOf> mRing{ &mSequence, mTimes.data(), mItems.data(), SIZE, SlotOf{} };
+};
+
+template<typename T, std::size_t SIZE>
+void
+SeqLockSearchRingBuffer<T, SIZE>::push(const time_point time, const T& item)
+{
+  const rep stamp = time.time_since_epoch().count();
+  if (mPushed != 0 && stamp < mNewestTime) // If the inserted time is less than latest time then cancel the insertion
+  {
+    throw ItemTooOld{};
+  }
+
+  mRing.write(mPushed, stamp, item);
+  ++mPushed;
+  mNewestTime = stamp;
+}
+
+template<typename T, std::size_t SIZE>
+T
+SeqLockSearchRingBuffer<T, SIZE>::read(const time_point requestedTime) const
+{
+  return readWith(requestedTime, [](const T& item) {
+    T copy;
+    std::memcpy(&copy, &item, sizeof(T));
+    return copy;
+  });
+}
+
+template<typename T, std::size_t SIZE>
+template<typename Reader>
+std::invoke_result_t<Reader, const T&>
+SeqLockSearchRingBuffer<T, SIZE>::readWith(const time_point requestedTime, Reader&& reader) const
+{
+  return mRing.template readWith<BufferEmpty>(requestedTime.time_since_epoch().count(), std::forward<Reader>(reader));
+}
+
+template<typename T, std::size_t SIZE>
+bool
+SeqLockSearchRingBuffer<T, SIZE>::isEmpty() const
+{
+  return mRing.isEmpty();
+}
+
+} // End namespace Concurrent
+#endif // End header guard
@@ -0,0 +1,134 @@
+#ifndef CONCURRENT_SIMDSEARCH_H
+#define CONCURRENT_SIMDSEARCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+namespace Concurrent
+{
+namespace Detail
+{
+
+// Keys which are a single 64 bit integer can be compared with packed 64 bit compares
+template<typename Key>
+struct IsSimdSearchable : std::bool_constant<std::is_integral_v<Key> && sizeof(Key) == sizeof(std::int64_t)>
+{
+};
+
+template<typename Clock, typename Duration>
+struct IsSimdSearchable<std::chrono::time_point<Clock, Duration>>
+  : std::bool_constant<std::is_integral_v<typename Duration::rep> && std::is_signed_v<typename Duration::rep> &&
+                       sizeof(std::chrono::time_point<Clock, Duration>) == sizeof(std::int64_t)>
+{
+};
+
+// Number of keys below which the binary search stops and the remaining keys are compared all at once.
+// 16 keys is two cache lines, which is four AVX2 compares.
+constexpr std::ptrdiff_t linearSearchThreshold = 16;
+
+// Number of bits set in a 4 bit compare mask
+constexpr int bitsSet[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+// The 64 bit integer a key is compared by
+template<typename Clock, typename Duration>
+std::int64_t
+keyBits(const std::chrono::time_point<Clock, Duration>& key)
+{
+  return key.time_since_epoch().count();
+}
+
+template<typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+std::conditional_t<std::is_signed_v<Integer>, std::int64_t, std::uint64_t>
+keyBits(const Integer key)
+{
+  return key;
+}
+
+// Count how many of the count sorted keys starting at keys are less than value.
+// The packed compares are signed, so unsigned keys have their top bit flipped first to keep the same order.
+// The vector loads go through the intrinsics' may alias types and the keys left over are compared as Key, so keys such as
+// long long are never read through an unrelated std::int64_t (long) pointer.
+template<typename Key>
+std::ptrdiff_t
+countLess(const Key* keys, std::ptrdiff_t count, const Key& value)
+{
+  static_assert(IsSimdSearchable<Key>::value);
+
+  std::ptrdiff_t less{ 0 };
+  std::ptrdiff_t i{ 0 };
+#if defined(__AVX2__) || defined(__SSE4_2__)
+  using Bits = decltype(keyBits(value));
+  constexpr std::int64_t flip = std::is_unsigned_v<Bits> ? static_cast<std::int64_t>(std::uint64_t{ 1 } << 63) : 0;
+  const std::int64_t     signedValue = static_cast<std::int64_t>(keyBits(value)) ^ flip;
+#endif
+#if defined(__AVX2__)
+  const __m256i target = _mm256_set1_epi64x(signedValue);
+  for (; i + 4 <= count; i += 4)
+  {
+    __m256i block = _mm256_loadu_si256(static_cast<const __m256i*>(static_cast<const void*>(keys + i)));
+    if constexpr (std::is_unsigned_v<Bits>)
+    {
+      block = _mm256_xor_si256(block, _mm256_set1_epi64x(flip));
+    }
+    const __m256i isLess = _mm256_cmpgt_epi64(target, block); // All ones in each lane where key < value
+    less += bitsSet[_mm256_movemask_pd(_mm256_castsi256_pd(isLess))];
+  }
+#elif defined(__SSE4_2__)
+  const __m128i target = _mm_set1_epi64x(signedValue);
+  for (; i + 2 <= count; i += 2)
+  {
+    __m128i block = _mm_loadu_si128(static_cast<const __m128i*>(static_cast<const void*>(keys + i)));
+    if constexpr (std::is_unsigned_v<Bits>)
+    {
+      block = _mm_xor_si128(block, _mm_set1_epi64x(flip));
+    }
+    const __m128i isLess = _mm_cmpgt_epi64(target, block); // All ones in each lane where key < value
+    less += bitsSet[_mm_movemask_pd(_mm_castsi128_pd(isLess))];
+  }
+#endif
+  for (; i < count; ++i)
+  {
+    less += (keys[i] < value) ? 1 : 0;
+  }
+  return less;
+}
+
+// Same result as std::lower_bound. Binary searches until the range is small, then finishes with packed compares
+// when the key type allows it and the compiler targets AVX2 or SSE4.2.
+template<typename Key>
+const Key*
+lowerBound(const Key* first, const Key* last, const Key& value)
+{
+  if constexpr (IsSimdSearchable<Key>::value)
+  {
+    while (last - first > linearSearchThreshold)
+    {
+      const Key* middle = first + (last - first) / 2;
+      if (*middle < value)
+      {
+        first = middle + 1;
+      }
+      else
+      {
+        last = middle;
+      }
+    }
+    // The keys are sorted, so the number which are less than value is the offset of the first which is not
+    return first + countLess(first, last - first, value);
+  }
+  else
+  {
+    return std::lower_bound(first, last, value);
+  }
+}
+
+} // End namespace Detail
+} // End namespace Concurrent
+#endif // End header guard
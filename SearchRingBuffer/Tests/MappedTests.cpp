@@ -0,0 +1,227 @@
+#include "MappedSearchRingBuffer.h"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using minutes = std::chrono::minutes;
+using sysClock = std::chrono::system_clock;
+using Buffer = Concurrent::MappedSearchRingBuffer<int>;
+
+namespace
+{
+// A file name in the temporary directory which is removed at the end of the test
+struct TempFile
+{
+  std::string path = (std::filesystem::temp_directory_path() / ("MappedTests." + std::to_string(::getpid()))).string();
+
+  TempFile() { std::filesystem::remove(path); }
+  ~TempFile() { std::filesystem::remove(path); }
+};
+
+// Trivially copyable but not default constructible
+struct Reading
+{
+  explicit Reading(const int v) : value(v) {}
+  int value;
+};
+
+// Where the layout puts the sequence counter and the first time stamp: the header's fields, then the counter on the next
+// cache line, then the time stamps from the cache line after the header
+constexpr std::streamoff sequenceOffset = 64;
+constexpr std::streamoff timesOffset = 128;
+} // End anonymous namespace
+
+SCENARIO("A mapped buffer keeps its data when reopened")
+{
+  GIVEN("A new mapped buffer of size 4")
+  {
+    TempFile file;
+    auto     time = sysClock::now();
+    {
+      Buffer circBuff(file.path, 4);
+      CHECK(circBuff.isEmpty() == true);
+      CHECK_THROWS_AS(circBuff.read(time), Buffer::BufferEmpty);
+      for (int i = 0; i < 6; ++i)
+      {
+        circBuff.push(time + minutes(10 * i), i);
+      }
+      circBuff.flush();
+    }
+
+    WHEN("It is reopened for pushing")
+    {
+      Buffer circBuff(file.path, 4);
+
+      THEN("The data is still there")
+      {
+        CHECK(circBuff.isEmpty() == false);
+        CHECK(circBuff.read(time) == 2);
+        CHECK(circBuff.read(time + minutes(34)) == 3);
+        CHECK(circBuff.read(time + minutes(100)) == 5);
+      }
+
+      THEN("Pushing carries on from the newest item")
+      {
+        CHECK_THROWS_AS(circBuff.push(time, 0), Buffer::ItemTooOld);
+        circBuff.push(time + minutes(60), 6);
+        CHECK(circBuff.read(time) == 3);
+        CHECK(circBuff.read(time + minutes(100)) == 6);
+      }
+
+      THEN("It can be read from a read only mapping at the same time")
+      {
+        const Buffer reader(file.path);
+        CHECK(reader.capacity() == 4);
+        CHECK(reader.read(time + minutes(100)) == 5);
+        circBuff.push(time + minutes(60), 6);
+        CHECK(reader.read(time + minutes(100)) == 6);
+        CHECK(reader.readWith(time, [](const int& item) { return item * 10; }) == 30);
+      }
+
+      THEN("A second writer is refused") { CHECK_THROWS_AS(Buffer(file.path, 4), std::system_error); }
+    }
+
+    WHEN("It is opened read only")
+    {
+      Buffer reader(file.path);
+
+      THEN("It cannot be pushed to") { CHECK_THROWS_AS(reader.push(time + minutes(100), 10), std::logic_error); }
+    }
+
+    THEN("It cannot be opened with a different capacity or type")
+    {
+      using DoubleBuffer = Concurrent::MappedSearchRingBuffer<double>;
+      CHECK_THROWS_AS(Buffer(file.path, 8), Buffer::IncompatibleFile);
+      CHECK_THROWS_AS(DoubleBuffer(file.path), DoubleBuffer::IncompatibleFile);
+    }
+  }
+
+  GIVEN("A full buffer whose writer stopped part way through a push")
+  {
+    TempFile file;
+    auto     time = sysClock::now();
+    {
+      Buffer circBuff(file.path, 4);
+      for (int i = 0; i < 4; ++i)
+      {
+        circBuff.push(time + minutes(10 * i), i);
+      }
+    }
+    {
+      // Mark a fifth push as started, which overwrites the slot of the oldest item, and leave a newer time in that slot
+      std::fstream         stream(file.path, std::ios::in | std::ios::out | std::ios::binary);
+      const std::uint64_t  started{ 2 * 4 + 1 };
+      const std::int64_t   halfWritten = (time + minutes(100)).time_since_epoch().count();
+      stream.seekp(sequenceOffset);
+      stream.write(reinterpret_cast<const char*>(&started), sizeof(started));
+      stream.seekp(timesOffset);
+      stream.write(reinterpret_cast<const char*>(&halfWritten), sizeof(halfWritten));
+    }
+
+    WHEN("It is opened read only")
+    {
+      const Buffer reader(file.path);
+
+      THEN("The slot being written is skipped")
+      {
+        CHECK(reader.read(time) == 1);
+        CHECK(reader.read(time + minutes(100)) == 3);
+      }
+    }
+
+    WHEN("It is reopened for pushing")
+    {
+      Buffer circBuff(file.path, 4);
+
+      THEN("The interrupted push is written again")
+      {
+        CHECK(circBuff.read(time) == 1);
+        circBuff.push(time + minutes(40), 4);
+        CHECK(circBuff.read(time) == 1);
+        CHECK(circBuff.read(time + minutes(100)) == 4);
+        CHECK(Buffer(file.path).read(time + minutes(34)) == 3);
+      }
+    }
+  }
+
+  GIVEN("A buffer of items which cannot be default constructed")
+  {
+    using ReadingBuffer = Concurrent::MappedSearchRingBuffer<Reading>;
+    TempFile      file;
+    auto          time = sysClock::now();
+    ReadingBuffer circBuff(file.path, 4);
+    circBuff.push(time, Reading(7));
+
+    THEN("An item can be read") { CHECK(circBuff.read(time).value == 7); }
+  }
+
+  GIVEN("A buffer whose writer stopped before it finished laying out the file")
+  {
+    TempFile file;
+    auto     time = sysClock::now();
+    {
+      Buffer circBuff(file.path, 4);
+    }
+    {
+      std::fstream  stream(file.path, std::ios::in | std::ios::out | std::ios::binary);
+      std::uint64_t noMagic{ 0 };
+      stream.write(reinterpret_cast<const char*>(&noMagic), sizeof(noMagic)); // The magic number is written last
+    }
+    REQUIRE_THROWS_AS(Buffer(file.path), Buffer::IncompatibleFile);
+
+    WHEN("It is opened for pushing")
+    {
+      Buffer circBuff(file.path, 4);
+
+      THEN("The file is laid out again as an empty buffer")
+      {
+        CHECK(circBuff.isEmpty() == true);
+        circBuff.push(time, 1);
+        CHECK(circBuff.read(time) == 1);
+        CHECK(Buffer(file.path).read(time) == 1);
+      }
+    }
+  }
+
+  GIVEN("A file which is not a buffer")
+  {
+    TempFile file;
+    std::ofstream(file.path) << "Not a buffer, but long enough to hold a header if it were one. Not a buffer, but long enough to hold a header.";
+
+    THEN("It cannot be opened") { CHECK_THROWS_AS(Buffer(file.path), Buffer::IncompatibleFile); }
+  }
+
+  GIVEN("A file which is not a buffer but starts with zeros")
+  {
+    TempFile                file;
+    const std::vector<char> contents = [] {
+      std::vector<char> bytes(4008, 'x');
+      std::fill(bytes.begin(), bytes.begin() + 8, '\0');
+      return bytes;
+    }();
+    std::ofstream(file.path, std::ios::binary).write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+    THEN("It cannot be opened for pushing and is left as it was")
+    {
+      CHECK_THROWS_AS(Buffer(file.path, 4), Buffer::IncompatibleFile);
+      std::ifstream           stream(file.path, std::ios::binary);
+      const std::vector<char> after{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+      CHECK(after == contents);
+    }
+  }
+
+  GIVEN("A file which does not exist")
+  {
+    TempFile file;
+
+    THEN("It cannot be opened read only") { CHECK_THROWS_AS(Buffer(file.path), std::system_error); }
+  }
+}
@@ -0,0 +1,121 @@
+#include "SeqLockSearchRingBuffer.h"
+#include "catch.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using minutes = std::chrono::minutes;
+using sysClock = std::chrono::system_clock;
+using Buffer = Concurrent::SeqLockSearchRingBuffer<int, 4>;
+
+SCENARIO("Basic use of a seqlock buffer")
+{
+  GIVEN("An empty buffer of size 4")
+  {
+    Buffer circBuff;
+    auto   time = sysClock::now();
+
+    THEN("The buffer is empty")
+    {
+      CHECK(circBuff.isEmpty() == true);
+      CHECK_THROWS_AS(circBuff.read(time), Buffer::BufferEmpty);
+    }
+
+    WHEN("More than 4 elements are pushed in")
+    {
+      for (int i = 0; i < 6; ++i)
+      {
+        circBuff.push(time + minutes(10 * i), i);
+      }
+
+      THEN("The closest of the last 4 elements is retrieved")
+      {
+        CHECK(circBuff.isEmpty() == false);
+        CHECK(circBuff.read(time) == 2);
+        CHECK(circBuff.read(time + minutes(20)) == 2);
+        CHECK(circBuff.read(time + minutes(34)) == 3);
+        CHECK(circBuff.read(time + minutes(36)) == 4);
+        CHECK(circBuff.read(time + minutes(50)) == 5);
+        CHECK(circBuff.read(time + minutes(100)) == 5);
+      }
+
+      THEN("Old data cannot be inserted")
+      {
+        CHECK_THROWS_AS(circBuff.push(time, 0), Buffer::ItemTooOld);
+        CHECK(circBuff.read(time + minutes(100)) == 5);
+      }
+    }
+
+    WHEN("Two elements have the same time")
+    {
+      circBuff.push(time, 1);
+      circBuff.push(time + minutes(1), 2);
+      circBuff.push(time + minutes(1), 3);
+      circBuff.push(time + minutes(2), 4);
+
+      THEN("The earlier element is retrieved") { CHECK(circBuff.read(time + minutes(1)) == 2); }
+    }
+
+    WHEN("Elements are read in place")
+    {
+      for (int i = 0; i < 6; ++i)
+      {
+        circBuff.push(time + minutes(10 * i), i);
+      }
+
+      THEN("The reader is given the closest element") { CHECK(circBuff.readWith(time + minutes(31), [](const int& item) { return item * 10; }) == 30); }
+    }
+  }
+}
+
+// The writer stores pairs where second is always the negative of first.
+// Readers check they never see a pair which is half written, and that the result is within the buffered window.
+TEST_CASE("Readers never see partially written data")
+{
+  struct Sample
+  {
+    long long first;
+    long long second;
+  };
+  constexpr long long                               count = 200000;
+  constexpr std::size_t                             size = 64;
+  Concurrent::SeqLockSearchRingBuffer<Sample, size> circBuff;
+  auto                                              time = sysClock::now();
+  std::atomic<long long>                            pushed{ 0 };
+  circBuff.push(time, Sample{ 0, 0 });
+
+  std::vector<std::thread> readers;
+  std::atomic<int>         errors{ 0 };
+  for (int r = 0; r < 3; ++r)
+  {
+    readers.emplace_back([&]() {
+      while (pushed.load() < count)
+      {
+        const long long newest = pushed.load();
+        const Sample    sample = circBuff.read(time + minutes(newest));
+        if (sample.first != -sample.second || sample.first + static_cast<long long>(size) < newest)
+        {
+          ++errors;
+        }
+        const long long sum = circBuff.readWith(time + minutes(newest), [](const Sample& inPlace) { return inPlace.first + inPlace.second; });
+        if (sum != 0)
+        {
+          ++errors;
+        }
+      }
+    });
+  }
+
+  for (long long i = 1; i <= count; ++i)
+  {
+    circBuff.push(time + minutes(i), Sample{ i, -i });
+    pushed.store(i);
+  }
+  for (auto& reader : readers)
+  {
+    reader.join();
+  }
+
+  CHECK(errors == 0);
+}
@@ -1,7 +1,12 @@
 #include "SearchRingBuffer.h"
 #include "catch.hpp"
 
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 using minutes = std::chrono::minutes;
 using hours = std::chrono::hours;
@@ -125,6 +130,21 @@ SCENARIO("When two elements have the same time the earliest one will be retrieve
       THEN("the earlier element with time = 10 will be retrieved") { CHECK(result == 2); }
     }
   }
+
+  GIVEN("A wrapped buffer with elements with the same time either side of the wrap")
+  {
+    Concurrent::SearchRingBuffer<int, 5> circBuff;
+    auto                                 time = sysClock::now();
+
+    for (int i = 0; i < 4; ++i)
+    {
+      circBuff.push(time + minutes(i), i);
+    }
+    circBuff.push(time + minutes(4), 4);
+    circBuff.push(time + minutes(4), 5); // Wraps to the first slot
+
+    THEN("the earlier element is retrieved") { CHECK(circBuff.read(time + minutes(4)) == 4); }
+  }
 }
 
 SCENARIO("When an even sized buffer has wrapped")
@@ -308,4 +328,835 @@ SCENARIO("When an element is requested that does not exist the closest match sha
       THEN("the closest match (1) will be retrieved") { CHECK(result == 40); }
     }
   }
-}
\ No newline at end of file
+}
+
+SCENARIO("Data can be constructed in place")
+{
+  GIVEN("A buffer of size 3")
+  {
+    Concurrent::SearchRingBuffer<std::string, 3> circBuff;
+    auto                                         time = sysClock::now();
+
+    WHEN("Strings are emplaced from their constructor arguments until the buffer wraps")
+    {
+      circBuff.emplace(time, 1, 'a');
+      circBuff.emplace(time + minutes(1), 2, 'b');
+      circBuff.emplace(time + minutes(2), 3, 'c');
+      circBuff.emplace(time + minutes(3), 4, 'd');
+
+      THEN("The constructed data can be retrieved")
+      {
+        CHECK(circBuff.read(time + minutes(1)) == "bb");
+        CHECK(circBuff.read(time + minutes(3)) == "dddd");
+      }
+    }
+
+    WHEN("An old item is emplaced")
+    {
+      using ItemTooOld = Concurrent::SearchRingBuffer<std::string, 3>::ItemTooOld;
+      circBuff.emplace(time + minutes(1), "new");
+      THEN("An exception is thrown") { CHECK_THROWS_AS(circBuff.emplace(time, "old"), ItemTooOld); }
+    }
+  }
+}
+
+SCENARIO("Interpolation search gives the same results as binary search")
+{
+  using InterpolatingBuffer = Concurrent::SearchRingBuffer<int, 100, Concurrent::InterpolationSearch<4>>;
+
+  GIVEN("A buffer using binary search and one using interpolation search")
+  {
+    Concurrent::SearchRingBuffer<int, 100> binaryBuff;
+    InterpolatingBuffer                    interpolatingBuff;
+    auto                                   time = sysClock::now();
+
+    WHEN("Evenly spaced data is pushed until the buffers wrap")
+    {
+      for (int i = 0; i < 150; ++i)
+      {
+        binaryBuff.push(time + minutes(10 * i), i);
+        interpolatingBuff.push(time + minutes(10 * i), i);
+      }
+
+      THEN("Every time gives the same result")
+      {
+        bool matches{ true };
+        for (int i = -10; i < 1600; ++i)
+        {
+          matches = matches && (binaryBuff.read(time + minutes(i)) == interpolatingBuff.read(time + minutes(i)));
+        }
+        CHECK(matches == true);
+      }
+    }
+
+    WHEN("Irregularly spaced data with duplicates is pushed until the buffers wrap")
+    {
+      int offset{ 0 };
+      for (int i = 0; i < 150; ++i)
+      {
+        offset += (i % 7 == 0) ? 0 : (i % 5) * (i % 5) * 10;
+        binaryBuff.push(time + minutes(offset), i);
+        interpolatingBuff.push(time + minutes(offset), i);
+      }
+
+      THEN("Every time gives the same result")
+      {
+        bool matches{ true };
+        for (int i = -10; i < offset + 10; ++i)
+        {
+          matches = matches && (binaryBuff.read(time + minutes(i)) == interpolatingBuff.read(time + minutes(i)));
+        }
+        CHECK(matches == true);
+      }
+    }
+  }
+}
+
+SCENARIO("The capacity of a dynamic buffer is chosen at run time")
+{
+  GIVEN("A dynamic buffer asked for 5 elements")
+  {
+    Concurrent::DynamicSearchRingBuffer<int> circBuff(5);
+    auto                                     time = sysClock::now();
+
+    THEN("The capacity is rounded up to a power of two")
+    {
+      CHECK(circBuff.capacity() == 8);
+      CHECK(circBuff.isEmpty() == true);
+    }
+
+    WHEN("It has wrapped")
+    {
+      for (int i = 0; i < 12; ++i)
+      {
+        circBuff.push(time + minutes(10 * i), i);
+      }
+
+      THEN("The closest of the last 8 elements is retrieved")
+      {
+        CHECK(circBuff.read(time) == 4);
+        CHECK(circBuff.read(time + minutes(44)) == 4);
+        CHECK(circBuff.read(time + minutes(76)) == 8);
+        CHECK(circBuff.read(time + minutes(200)) == 11);
+      }
+    }
+  }
+
+  GIVEN("A dynamic buffer using huge pages")
+  {
+    Concurrent::HeapOptions options;
+    options.hugePages = true;
+    Concurrent::DynamicSearchRingBuffer<std::string> circBuff(1000, options);
+    auto                                             time = sysClock::now();
+
+    WHEN("Data is pushed in")
+    {
+      circBuff.push(time, "Hello");
+      circBuff.push(time + minutes(1), "World");
+
+      THEN("It is retrieved as normal")
+      {
+        CHECK(circBuff.capacity() == 1024);
+        CHECK(circBuff.read(time + minutes(1)) == "World");
+      }
+    }
+  }
+
+  GIVEN("A capacity of zero")
+  {
+    THEN("An exception is thrown") { CHECK_THROWS_AS(Concurrent::DynamicSearchRingBuffer<int>(0), std::invalid_argument); }
+  }
+}
+
+SCENARIO("All the items in a time window can be read at once")
+{
+  GIVEN("A buffer of size 5")
+  {
+    Concurrent::SearchRingBuffer<int, 5> circBuff;
+    auto                                 time = sysClock::now();
+    std::vector<int>                     output;
+
+    THEN("Reading a range of an empty buffer gives nothing")
+    {
+      circBuff.readRange(time, time + minutes(100), std::back_inserter(output));
+      CHECK(output.empty());
+    }
+
+    WHEN("The buffer has wrapped")
+    {
+      for (int i = 0; i < 8; ++i)
+      {
+        circBuff.push(time + minutes(10 * i), i); // Holds 3 to 7
+      }
+
+      THEN("A range across the wrap is read in time order")
+      {
+        circBuff.readRange(time + minutes(25), time + minutes(65), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 3, 4, 5, 6 });
+      }
+
+      THEN("Both ends of the range are included")
+      {
+        circBuff.readRange(time + minutes(40), time + minutes(60), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 4, 5, 6 });
+      }
+
+      THEN("A range which covers the whole buffer reads everything")
+      {
+        circBuff.readRange(time, time + minutes(100), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 3, 4, 5, 6, 7 });
+      }
+
+      THEN("Ranges with no items give nothing")
+      {
+        circBuff.readRange(time, time + minutes(20), std::back_inserter(output));
+        circBuff.readRange(time + minutes(41), time + minutes(49), std::back_inserter(output));
+        circBuff.readRange(time + minutes(80), time + minutes(100), std::back_inserter(output));
+        circBuff.readRange(time + minutes(60), time + minutes(40), std::back_inserter(output));
+        CHECK(output.empty());
+      }
+
+      THEN("The visitor is given each time and item")
+      {
+        std::vector<sysClock::time_point> times;
+        circBuff.forEachInRange(time + minutes(50), time + minutes(70), [&](const sysClock::time_point& t, const int& item) {
+          times.push_back(t);
+          output.push_back(item);
+        });
+        CHECK(times == std::vector<sysClock::time_point>{ time + minutes(50), time + minutes(60), time + minutes(70) });
+        CHECK(output == std::vector<int>{ 5, 6, 7 });
+      }
+    }
+
+    WHEN("Items have the same time")
+    {
+      circBuff.push(time, 1);
+      circBuff.push(time + minutes(1), 2);
+      circBuff.push(time + minutes(1), 3);
+      circBuff.push(time + minutes(2), 4);
+
+      THEN("All of them are read")
+      {
+        circBuff.readRange(time + minutes(1), time + minutes(1), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 2, 3 });
+      }
+    }
+  }
+}
+
+SCENARIO("Many times can be read at once")
+{
+  GIVEN("A buffer of size 50")
+  {
+    Concurrent::SearchRingBuffer<int, 50> circBuff;
+    auto                                  time = sysClock::now();
+    std::vector<sysClock::time_point>     requested;
+    std::vector<int>                      output;
+
+    THEN("Reading from an empty buffer throws unless no times are requested")
+    {
+      using BufferEmpty = Concurrent::SearchRingBuffer<int, 50>::BufferEmpty;
+      CHECK_NOTHROW(circBuff.readMany(requested.begin(), requested.end(), std::back_inserter(output)));
+      CHECK(output.empty());
+      requested.push_back(time);
+      CHECK_THROWS_AS(circBuff.readMany(requested.begin(), requested.end(), std::back_inserter(output)), BufferEmpty);
+    }
+
+    WHEN("Irregularly spaced data with duplicates is pushed until the buffer wraps")
+    {
+      int offset{ 0 };
+      for (int i = 0; i < 80; ++i)
+      {
+        offset += (i % 7 == 0) ? 0 : (i % 5) * (i % 5) * 10;
+        circBuff.push(time + minutes(offset), i);
+      }
+
+      THEN("Sorted times give the same results as read()")
+      {
+        for (int i = -10; i < offset + 10; ++i)
+        {
+          requested.push_back(time + minutes(i));
+        }
+        circBuff.readMany(requested.begin(), requested.end(), std::back_inserter(output));
+
+        std::vector<int> expected;
+        for (const auto& t : requested)
+        {
+          expected.push_back(circBuff.read(t));
+        }
+        CHECK(output == expected);
+      }
+
+      THEN("Unsorted times give the same results as read()")
+      {
+        requested = { time + minutes(offset), time + minutes(offset / 2), time, time + minutes(offset / 3), time + minutes(offset + 5) };
+        circBuff.readMany(requested.begin(), requested.end(), std::back_inserter(output));
+
+        std::vector<int> expected;
+        for (const auto& t : requested)
+        {
+          expected.push_back(circBuff.read(t));
+        }
+        CHECK(output == expected);
+      }
+    }
+
+    WHEN("The buffer is not full")
+    {
+      for (int i = 0; i < 10; ++i)
+      {
+        circBuff.push(time + minutes(10 * i), i);
+      }
+
+      THEN("The closest items are read")
+      {
+        requested = { time - minutes(5), time + minutes(14), time + minutes(16), time + minutes(50), time + minutes(500) };
+        circBuff.readMany(requested.begin(), requested.end(), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 0, 1, 2, 5, 9 });
+      }
+    }
+  }
+}
+
+namespace
+{
+struct Point
+{
+  double x;
+  double y;
+};
+
+// Counts how many times it is copied
+struct Frame
+{
+  Frame() = default;
+  Frame(int id) : id(id) {}
+  Frame(const Frame& other) : id(other.id) { ++copies; }
+  Frame&
+  operator=(const Frame& other)
+  {
+    id = other.id;
+    ++copies;
+    return *this;
+  }
+
+  int               id{ 0 };
+  inline static int copies{ 0 };
+};
+
+// Throws when copying the item whose id is throwOn
+struct Fragile
+{
+  Fragile() = default;
+  Fragile(int id) : id(id) {}
+  Fragile(const Fragile& other) : id(other.id) { check(other); }
+  Fragile&
+  operator=(const Fragile& other)
+  {
+    check(other);
+    id = other.id;
+    return *this;
+  }
+  static void
+  check(const Fragile& other)
+  {
+    if (other.id == throwOn)
+    {
+      throw std::runtime_error("Copy failed");
+    }
+  }
+
+  int               id{ 0 };
+  inline static int throwOn{ -1 };
+};
+} // End anonymous namespace
+
+template<>
+struct Concurrent::Interpolate<Point>
+{
+  static Point lerp(const Point& below, const Point& above, double fraction)
+  {
+    return Point{ below.x + (above.x - below.x) * fraction, below.y + (above.y - below.y) * fraction };
+  }
+};
+
+SCENARIO("Items either side of the requested time can be blended")
+{
+  GIVEN("A wrapped buffer of doubles")
+  {
+    Concurrent::SearchRingBuffer<double, 4> circBuff;
+    auto                                    time = sysClock::now();
+    for (int i = 0; i < 6; ++i)
+    {
+      circBuff.push(time + minutes(10 * i), 100.0 * i); // Holds 200 to 500
+    }
+
+    THEN("Times between items are interpolated, including across the wrap")
+    {
+      CHECK(circBuff.readInterpolated(time + minutes(25)) == Approx(250.0));
+      CHECK(circBuff.readInterpolated(time + minutes(39)) == Approx(390.0));
+      CHECK(circBuff.readInterpolated(time + minutes(41)) == Approx(410.0));
+    }
+
+    THEN("Exact times give the item")
+    {
+      CHECK(circBuff.readInterpolated(time + minutes(30)) == 300.0);
+      CHECK(circBuff.readInterpolated(time + minutes(50)) == 500.0);
+    }
+
+    THEN("Times outside the buffer give the oldest or newest item")
+    {
+      CHECK(circBuff.readInterpolated(time) == 200.0);
+      CHECK(circBuff.readInterpolated(time + minutes(100)) == 500.0);
+    }
+  }
+
+  GIVEN("A buffer of unsigned integers which decrease")
+  {
+    Concurrent::SearchRingBuffer<unsigned, 4> circBuff;
+    auto                                      time = sysClock::now();
+    circBuff.push(time, 10u);
+    circBuff.push(time + minutes(4), 0u);
+
+    THEN("The result is rounded to the nearest value") { CHECK(circBuff.readInterpolated(time + minutes(1)) == 8u); }
+  }
+
+  GIVEN("A buffer of a type with its own interpolation")
+  {
+    Concurrent::SearchRingBuffer<Point, 4> circBuff;
+    auto                                   time = sysClock::now();
+    circBuff.push(time, Point{ 0.0, 10.0 });
+    circBuff.push(time + minutes(10), Point{ 10.0, 0.0 });
+
+    THEN("Interpolate is used to blend the items")
+    {
+      const Point result = circBuff.readInterpolated(time + minutes(3));
+      CHECK(result.x == Approx(3.0));
+      CHECK(result.y == Approx(7.0));
+    }
+  }
+}
+
+SCENARIO("Items can be read in place without copying them")
+{
+  GIVEN("A buffer with some large items in it")
+  {
+    Concurrent::SearchRingBuffer<Frame, 4> circBuff;
+    auto                                   time = sysClock::now();
+    for (int i = 0; i < 6; ++i)
+    {
+      circBuff.emplace(time + minutes(10 * i), i);
+    }
+
+    WHEN("Fields are read with readWith")
+    {
+      Frame::copies = 0;
+      const int id = circBuff.readWith(time + minutes(31), [](const Frame& frame) { return frame.id; });
+
+      THEN("The closest item is read and nothing is copied")
+      {
+        CHECK(id == 3);
+        CHECK(Frame::copies == 0);
+      }
+    }
+
+    WHEN("The item is read with read")
+    {
+      Frame::copies = 0;
+      const Frame frame = circBuff.read(time + minutes(31));
+
+      THEN("It is copied once")
+      {
+        CHECK(frame.id == 3);
+        CHECK(Frame::copies == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("A batch of items can be pushed at once")
+{
+  using Batch = std::vector<std::pair<sysClock::time_point, int>>;
+
+  GIVEN("A buffer of size 5")
+  {
+    Concurrent::SearchRingBuffer<int, 5> circBuff;
+    auto                                 time = sysClock::now();
+    std::vector<int>                     output;
+
+    WHEN("A batch which does not fill it is pushed")
+    {
+      Batch batch{ { time, 0 }, { time + minutes(10), 1 }, { time + minutes(20), 2 } };
+      circBuff.pushRange(batch.begin(), batch.end());
+
+      THEN("The items are read as if pushed one at a time")
+      {
+        circBuff.readRange(time, time + minutes(100), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 0, 1, 2 });
+        CHECK(circBuff.read(time + minutes(14)) == 1);
+      }
+
+      AND_WHEN("A second batch wraps round the end of the buffer")
+      {
+        Batch more{ { time + minutes(30), 3 }, { time + minutes(40), 4 }, { time + minutes(50), 5 }, { time + minutes(60), 6 } };
+        circBuff.pushRange(more.begin(), more.end());
+
+        THEN("The oldest items are replaced")
+        {
+          circBuff.readRange(time, time + minutes(100), std::back_inserter(output));
+          CHECK(output == std::vector<int>{ 2, 3, 4, 5, 6 });
+          CHECK(circBuff.read(time) == 2);
+          CHECK(circBuff.read(time + minutes(100)) == 6);
+        }
+
+        THEN("Single pushes carry on from the batch")
+        {
+          circBuff.push(time + minutes(70), 7);
+          circBuff.readRange(time, time + minutes(100), std::back_inserter(output));
+          CHECK(output == std::vector<int>{ 3, 4, 5, 6, 7 });
+        }
+      }
+    }
+
+    WHEN("A batch larger than the buffer is pushed")
+    {
+      Batch batch;
+      for (int i = 0; i < 12; ++i)
+      {
+        batch.emplace_back(time + minutes(10 * i), i);
+      }
+      circBuff.pushRange(batch.begin(), batch.end());
+
+      THEN("Only the newest items are kept")
+      {
+        circBuff.readRange(time, time + minutes(200), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 7, 8, 9, 10, 11 });
+      }
+    }
+
+    WHEN("A batch is out of order")
+    {
+      using ItemTooOld = Concurrent::SearchRingBuffer<int, 5>::ItemTooOld;
+      circBuff.push(time + minutes(10), 1);
+      Batch tooOld{ { time, 0 } };
+      Batch unsorted{ { time + minutes(20), 2 }, { time + minutes(40), 4 }, { time + minutes(30), 3 } };
+
+      THEN("An exception is thrown and nothing is inserted")
+      {
+        CHECK_THROWS_AS(circBuff.pushRange(tooOld.begin(), tooOld.end()), ItemTooOld);
+        CHECK_THROWS_AS(circBuff.pushRange(unsorted.begin(), unsorted.end()), ItemTooOld);
+        circBuff.readRange(time, time + minutes(100), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 1 });
+      }
+    }
+  }
+}
+
+SCENARIO("A batch which fails part way through leaves the buffer valid")
+{
+  using Batch = std::vector<std::pair<sysClock::time_point, Fragile>>;
+
+  GIVEN("A full buffer of size 4 of items whose copies may throw")
+  {
+    Concurrent::SearchRingBuffer<Fragile, 4> circBuff;
+    auto                                     time = sysClock::now();
+    for (int i = 0; i < 4; ++i)
+    {
+      circBuff.push(time + minutes(10 * i), Fragile{ i });
+    }
+
+    WHEN("Copying the second item of a batch throws")
+    {
+      Batch batch{ { time + minutes(40), Fragile{ 4 } }, { time + minutes(50), Fragile{ 5 } }, { time + minutes(60), Fragile{ 6 } } };
+      Fragile::throwOn = 5;
+      CHECK_THROWS_AS(circBuff.pushRange(batch.begin(), batch.end()), std::runtime_error);
+      Fragile::throwOn = -1;
+
+      THEN("The items before it are pushed and the buffer is still sorted")
+      {
+        std::vector<int> ids;
+        circBuff.forEachInRange(time, time + minutes(100), [&ids](const auto&, const Fragile& item) { ids.push_back(item.id); });
+        CHECK(ids == std::vector<int>{ 1, 2, 3, 4 });
+        CHECK(circBuff.read(time).id == 1);
+        CHECK(circBuff.read(time + minutes(31)).id == 3);
+        CHECK(circBuff.read(time + minutes(100)).id == 4);
+      }
+    }
+  }
+}
+
+SCENARIO("Old items and empty buffers can be handled without exceptions")
+{
+  GIVEN("An empty buffer of size 3")
+  {
+    Concurrent::SearchRingBuffer<std::string, 3> circBuff;
+    auto                                         time = sysClock::now();
+
+    THEN("tryRead gives nothing") { CHECK(circBuff.tryRead(time) == std::nullopt); }
+
+    WHEN("Items are pushed with tryPush and tryEmplace")
+    {
+      CHECK(circBuff.tryPush(time, "first") == Concurrent::PushStatus::Pushed);
+      CHECK(circBuff.tryEmplace(time + minutes(10), 3, 'b') == Concurrent::PushStatus::Pushed);
+
+      THEN("They are read with tryRead")
+      {
+        CHECK(circBuff.tryRead(time + minutes(2)) == std::optional<std::string>("first"));
+        CHECK(circBuff.tryRead(time + minutes(100)) == std::optional<std::string>("bbb"));
+      }
+
+      THEN("Older items are reported and not inserted")
+      {
+        CHECK(circBuff.tryPush(time + minutes(5), "late") == Concurrent::PushStatus::ItemTooOld);
+        CHECK(circBuff.tryEmplace(time, "late") == Concurrent::PushStatus::ItemTooOld);
+        CHECK(circBuff.read(time + minutes(4)) == "first");
+        CHECK(circBuff.read(time + minutes(100)) == "bbb");
+      }
+    }
+  }
+}
+
+SCENARIO("Slightly late items can be inserted in time order")
+{
+  using ItemTooOld = Concurrent::SearchRingBuffer<int, 5>::ItemTooOld;
+
+  GIVEN("A buffer of size 5 which accepts items up to 15 minutes late")
+  {
+    Concurrent::SearchRingBuffer<int, 5> circBuff;
+    auto                                 time = sysClock::now();
+    std::vector<int>                     output;
+    circBuff.setMaxLateness(minutes(15));
+
+    circBuff.push(time + minutes(10), 10);
+    circBuff.push(time + minutes(20), 20);
+    circBuff.push(time + minutes(30), 30);
+
+    WHEN("Items within the window are pushed late")
+    {
+      circBuff.push(time + minutes(25), 25);
+      circBuff.push(time + minutes(20), 21); // Same time as an existing item
+
+      THEN("They are inserted in time order, after items with the same time")
+      {
+        circBuff.readRange(time, time + minutes(100), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 10, 20, 21, 25, 30 });
+        CHECK(circBuff.read(time + minutes(24)) == 25);
+        CHECK(circBuff.read(time + minutes(20)) == 20);
+      }
+
+      AND_WHEN("The buffer wraps with more late items")
+      {
+        circBuff.push(time + minutes(40), 40);
+        circBuff.push(time + minutes(35), 35);
+        circBuff.push(time + minutes(28), 28);
+
+        THEN("The oldest items are replaced and the rest stay in time order")
+        {
+          circBuff.readRange(time, time + minutes(100), std::back_inserter(output));
+          CHECK(output == std::vector<int>{ 25, 28, 30, 35, 40 });
+          CHECK(circBuff.read(time) == 25);
+          CHECK(circBuff.read(time + minutes(27)) == 28);
+        }
+      }
+    }
+
+    WHEN("An item is later than the window")
+    {
+      THEN("It is rejected")
+      {
+        CHECK_THROWS_AS(circBuff.push(time + minutes(14), 14), ItemTooOld);
+        CHECK(circBuff.tryPush(time + minutes(14), 14) == Concurrent::PushStatus::ItemTooOld);
+        circBuff.readRange(time, time + minutes(100), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 10, 20, 30 });
+      }
+    }
+
+    WHEN("A late item is older than every item in a buffer which is not full")
+    {
+      circBuff.setMaxLateness(minutes(30));
+      circBuff.push(time + minutes(5), 5);
+
+      THEN("It becomes the oldest item")
+      {
+        circBuff.readRange(time, time + minutes(100), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 5, 10, 20, 30 });
+        CHECK(circBuff.read(time) == 5);
+      }
+    }
+
+    WHEN("A late item is older than every item in a full buffer")
+    {
+      circBuff.push(time + minutes(40), 40);
+      circBuff.push(time + minutes(50), 50);
+      circBuff.setMaxLateness(minutes(60));
+
+      THEN("It is rejected as it would be overwritten straight away")
+      {
+        CHECK(circBuff.tryPush(time + minutes(5), 5) == Concurrent::PushStatus::ItemTooOld);
+        circBuff.readRange(time, time + minutes(100), std::back_inserter(output));
+        CHECK(output == std::vector<int>{ 10, 20, 30, 40, 50 });
+      }
+    }
+  }
+}
+
+SCENARIO("Items can be keyed by other clocks and by integers")
+{
+  GIVEN("A buffer keyed by steady_clock")
+  {
+    using steadyClock = std::chrono::steady_clock;
+    Concurrent::SearchRingBuffer<int, 4, Concurrent::BinarySearch, steadyClock::time_point> circBuff;
+    auto                                                                                  time = steadyClock::now();
+    for (int i = 0; i < 6; ++i)
+    {
+      circBuff.push(time + minutes(10 * i), i);
+    }
+
+    THEN("The closest item is retrieved")
+    {
+      CHECK(circBuff.read(time) == 2);
+      CHECK(circBuff.read(time + minutes(34)) == 3);
+      CHECK(circBuff.read(time + minutes(100)) == 5);
+    }
+  }
+
+  GIVEN("A buffer keyed by sequence numbers")
+  {
+    using SequenceBuffer = Concurrent::SearchRingBuffer<double, 8, Concurrent::BinarySearch, std::uint64_t>;
+    SequenceBuffer circBuff;
+    for (std::uint64_t sequence = 100; sequence < 120; sequence += 2)
+    {
+      circBuff.push(sequence, static_cast<double>(sequence) / 10.0);
+    }
+
+    THEN("The closest item is retrieved")
+    {
+      CHECK(circBuff.read(0) == 10.4);
+      CHECK(circBuff.read(109) == 11.0);
+      CHECK(circBuff.read(110) == 11.0);
+      CHECK(circBuff.read(1000) == 11.8);
+    }
+
+    THEN("Items in between can be interpolated") { CHECK(circBuff.readInterpolated(109) == Approx(10.9)); }
+
+    THEN("Late items are measured in sequence numbers")
+    {
+      using ItemTooOld = SequenceBuffer::ItemTooOld;
+      circBuff.setMaxLateness(3);
+      circBuff.push(117, 11.7);
+      CHECK(circBuff.read(117) == 11.7);
+      CHECK_THROWS_AS(circBuff.push(114, 11.4), ItemTooOld);
+    }
+  }
+
+  GIVEN("A buffer keyed by signed integers using interpolation search")
+  {
+    Concurrent::SearchRingBuffer<int, 100, Concurrent::InterpolationSearch<>, std::int64_t> circBuff;
+    for (int i = 0; i < 150; ++i)
+    {
+      circBuff.push(std::int64_t{ 10 } * i - 500, i);
+    }
+
+    THEN("The closest item is retrieved")
+    {
+      CHECK(circBuff.read(-1000) == 50);
+      CHECK(circBuff.read(496) == 100);
+      CHECK(circBuff.read(504) == 100);
+      CHECK(circBuff.read(5000) == 149);
+    }
+  }
+}
+
+SCENARIO("A buffer can count its activity")
+{
+  using CountedBuffer = Concurrent::SearchRingBuffer<int, 4, Concurrent::BinarySearch, std::uint64_t, Concurrent::CountBufferStats>;
+
+  THEN("The default policy adds nothing to the size of the buffer")
+  {
+    CHECK(sizeof(Concurrent::SearchRingBuffer<int, 4, Concurrent::BinarySearch, std::uint64_t>) ==
+          sizeof(Concurrent::SearchRingBuffer<int, 4, Concurrent::BinarySearch, std::uint64_t, Concurrent::NoBufferStats>));
+  }
+
+  GIVEN("A buffer of size 4 which counts its activity")
+  {
+    CountedBuffer circBuff;
+
+    THEN("Every counter starts at zero")
+    {
+      const Concurrent::BufferStats stats = circBuff.stats();
+      CHECK(stats.pushes == 0);
+      CHECK(stats.reads == 0);
+      CHECK(stats.rejections == 0);
+      CHECK(stats.overwrites == 0);
+    }
+
+    WHEN("6 items are pushed")
+    {
+      for (std::uint64_t i = 0; i < 6; ++i)
+      {
+        circBuff.push(10 * i, static_cast<int>(i));
+      }
+
+      THEN("The 2 oldest are counted as overwritten")
+      {
+        CHECK(circBuff.stats().pushes == 6);
+        CHECK(circBuff.stats().overwrites == 2);
+      }
+
+      THEN("Old items are counted as rejected, whether or not the push throws")
+      {
+        CHECK(circBuff.tryPush(0, 0) == Concurrent::PushStatus::ItemTooOld);
+        CHECK_THROWS_AS(circBuff.push(0, 0), CountedBuffer::ItemTooOld);
+        CHECK(circBuff.stats().rejections == 2);
+        CHECK(circBuff.stats().pushes == 6);
+      }
+
+      THEN("Each read is counted, and readMany() counts each time")
+      {
+        circBuff.read(20);
+        circBuff.tryRead(30);
+        circBuff.readWith(40, [](const int item) { return item; });
+        circBuff.readInterpolated(25);
+        std::vector<int>           out;
+        std::vector<std::uint64_t> requested{ 20, 30, 40 };
+        circBuff.readRange(20, 40, std::back_inserter(out));
+        circBuff.readMany(requested.begin(), requested.end(), std::back_inserter(out));
+        CHECK(circBuff.stats().reads == 8);
+      }
+    }
+
+    WHEN("A batch larger than the buffer is pushed after 2 items")
+    {
+      circBuff.push(0, 0);
+      circBuff.push(10, 1);
+      std::vector<std::pair<std::uint64_t, int>> batch{ { 20, 2 }, { 30, 3 }, { 40, 4 }, { 50, 5 }, { 60, 6 } };
+      circBuff.pushRange(batch.begin(), batch.end());
+
+      THEN("The items held are pushes less overwrites")
+      {
+        const Concurrent::BufferStats stats = circBuff.stats();
+        CHECK(stats.pushes == 7);
+        CHECK(stats.overwrites == 3);
+      }
+
+      THEN("A batch which goes back in time is rejected once")
+      {
+        std::vector<std::pair<std::uint64_t, int>> late{ { 70, 7 }, { 65, 6 } };
+        CHECK_THROWS_AS(circBuff.pushRange(late.begin(), late.end()), CountedBuffer::ItemTooOld);
+        CHECK(circBuff.stats().rejections == 1);
+      }
+    }
+
+    WHEN("A late item is inserted into a full buffer")
+    {
+      circBuff.setMaxLateness(15);
+      for (std::uint64_t i = 0; i < 4; ++i)
+      {
+        circBuff.push(10 * i, static_cast<int>(i));
+      }
+      circBuff.push(25, 25);
+
+      THEN("It pushes the oldest item out") { CHECK(circBuff.stats().overwrites == 1); }
+    }
+  }
+}
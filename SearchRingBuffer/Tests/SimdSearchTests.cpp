@@ -0,0 +1,66 @@
+#include "SimdSearch.h"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using sysClock = std::chrono::system_clock;
+
+TEST_CASE("Detail::lowerBound matches std::lower_bound")
+{
+  std::mt19937_64                             generator(42);
+  std::uniform_int_distribution<std::int64_t> step(0, 3); // Small steps so there are duplicate time stamps
+
+  for (std::size_t size : { 0, 1, 2, 3, 5, 15, 16, 17, 31, 64, 1000 })
+  {
+    std::vector<sysClock::time_point> times;
+    sysClock::time_point              time = sysClock::now();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      time += sysClock::duration(step(generator));
+      times.push_back(time);
+    }
+
+    const auto* first = times.data();
+    const auto* last = times.data() + times.size();
+    bool        matches{ true };
+    for (std::int64_t offset = -2; offset < static_cast<std::int64_t>(size) * 3 + 2; ++offset)
+    {
+      const auto requested = (times.empty() ? time : times.front()) + sysClock::duration(offset);
+      matches = matches && (Concurrent::Detail::lowerBound(first, last, requested) == std::lower_bound(first, last, requested));
+    }
+    INFO("Size " << size);
+    CHECK(matches == true);
+  }
+}
+
+TEMPLATE_TEST_CASE("Detail::lowerBound matches std::lower_bound for integer keys", "", std::int64_t, std::uint64_t, long long, unsigned long long)
+{
+  std::mt19937_64                             generator(7);
+  std::uniform_int_distribution<std::int64_t> step(0, 3);
+
+  // Start just below the point where the top bit changes, so signed keys cross zero and unsigned keys cross 2^63
+  const TestType start = std::is_signed_v<TestType> ? TestType(-100) : (TestType{ 1 } << 63) - 100;
+  for (std::size_t size : { 0, 1, 3, 16, 17, 100 })
+  {
+    std::vector<TestType> keys;
+    TestType              key = start;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      key += static_cast<TestType>(step(generator));
+      keys.push_back(key);
+    }
+
+    const auto* first = keys.data();
+    const auto* last = keys.data() + keys.size();
+    bool        matches{ true };
+    for (TestType requested = start - 2; requested != start + static_cast<TestType>(size * 3 + 2); ++requested)
+    {
+      matches = matches && (Concurrent::Detail::lowerBound(first, last, requested) == std::lower_bound(first, last, requested));
+    }
+    INFO("Size " << size);
+    CHECK(matches == true);
+  }
+}